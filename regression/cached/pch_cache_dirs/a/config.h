@@ -0,0 +1 @@
+#define LIMIT 10
@@ -0,0 +1,9 @@
+#include <assert.h>
+#include "config.h"
+
+int main()
+{
+  // Same prelude as the other directory, but not the same config.h
+  assert(LIMIT == 10);
+  return 0;
+}
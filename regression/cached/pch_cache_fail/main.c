@@ -0,0 +1,14 @@
+#include <assert.h>
+#include <limits.h>
+
+int nondet_int();
+
+int main()
+{
+  int n = nondet_int();
+  __ESBMC_assume(n > 0);
+
+  // INT_MAX comes from the precompiled prelude
+  assert(n < INT_MAX);
+  return 0;
+}
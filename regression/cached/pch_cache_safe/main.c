@@ -0,0 +1,14 @@
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+
+int main()
+{
+  char src[] = "prelude";
+  char dst[sizeof(src)];
+  memcpy(dst, src, sizeof(src));
+
+  assert(strlen(dst) == 7);
+  assert(INT8_MAX == 127);
+  return 0;
+}
@@ -0,0 +1,14 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  char buf[8] = {0};
+  int i = nondet_int();
+  __ESBMC_assume(i >= 0 && i < 8);
+
+  buf[i] = 1;
+  assert(buf[3] == 0);
+  return 0;
+}
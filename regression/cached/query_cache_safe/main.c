@@ -0,0 +1,16 @@
+#include <assert.h>
+
+unsigned int nondet_uint();
+
+int main()
+{
+  unsigned int n = nondet_uint();
+  __ESBMC_assume(n < 10);
+
+  unsigned int sum = 0;
+  for(unsigned int i = 0; i < n; i++)
+    sum += i;
+
+  assert(sum <= 45);
+  return 0;
+}
@@ -0,0 +1,93 @@
+#!/usr/bin/env python3
+
+# Runs esbmc twice on each test case, with %CACHE% in the arguments replaced
+# by a fresh directory, and checks the output of both runs against the
+# test.desc regexes. The first run fills the cache and the second one must
+# be answered from it.
+#
+# The test file line may name a different file for the second run. For the
+# PCH cache that file must then get a PCH of its own.
+#
+# Usage: run_cached.py <esbmc> <directory of test cases>
+
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+QUERY_HIT = r"^Verdict found in the query cache$"
+
+
+def run_esbmc(esbmc, case_dir, test_file, test_args):
+    proc = subprocess.run(
+        [esbmc, test_file] + test_args, cwd=case_dir,
+        stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    return proc.stdout.decode()
+
+
+def pch_files(cache_dir):
+    # A PCH that is built again replaces the file, so its identity changes
+    pchs = {}
+    for name in os.listdir(cache_dir):
+        if name.endswith(".pch"):
+            st = os.stat(os.path.join(cache_dir, name))
+            pchs[name] = (st.st_ino, st.st_mtime_ns)
+    return pchs
+
+
+def run_case(esbmc, case_dir):
+    with open(os.path.join(case_dir, "test.desc")) as fp:
+        lines = [line.strip() for line in fp]
+    test_files, test_args, regexes = lines[1].split(), lines[2].split(), \
+        lines[3:]
+    if len(test_files) == 1:
+        test_files.append(test_files[0])
+
+    pchs = []
+    with tempfile.TemporaryDirectory() as tmp:
+        args = [tmp if arg == "%CACHE%" else arg for arg in test_args]
+        outputs = []
+        for test_file in test_files:
+            outputs.append(run_esbmc(esbmc, case_dir, test_file, args))
+            pchs.append(pch_files(tmp))
+
+    for run, output in enumerate(outputs, 1):
+        for regex in regexes:
+            if regex and not re.search(regex, output, re.MULTILINE):
+                return "run {}: expected to find '{}' in:\n{}".format(
+                    run, regex, output)
+
+    if "--query-cache" in test_args:
+        if re.search(QUERY_HIT, outputs[0], re.MULTILINE):
+            return "query cache hit on the first run:\n" + outputs[0]
+        if not re.search(QUERY_HIT, outputs[1], re.MULTILINE):
+            return "no query cache hit on the second run:\n" + outputs[1]
+    if "--pch-cache" in test_args:
+        if not pchs[0]:
+            return "no PCH built by the first run:\n" + outputs[0]
+        if test_files[0] == test_files[1]:
+            if pchs[1] != pchs[0]:
+                return "the PCH wasn't reused:\n" + outputs[1]
+        elif len(pchs[1]) != len(pchs[0]) + 1:
+            return "the second file didn't get a PCH of its own:\n" + \
+                outputs[1]
+    return None
+
+
+def main():
+    esbmc, base = sys.argv[1:3]
+    failed = False
+    for case in sorted(os.listdir(base)):
+        case_dir = os.path.join(base, case)
+        if not os.path.isdir(case_dir):
+            continue
+        error = run_case(esbmc, case_dir)
+        if error:
+            print("{}: {}".format(case, error))
+            failed = True
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
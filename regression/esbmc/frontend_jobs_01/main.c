@@ -0,0 +1,16 @@
+#include <assert.h>
+
+int nondet_int();
+int scale(int x);
+extern int table[4];
+
+int main()
+{
+  int i = nondet_int();
+  __ESBMC_assume(i >= 0 && i < 4);
+
+  // Both the function and the table are converted on other workers
+  int y = scale(table[i]);
+  assert(y > table[i]);
+  return 0;
+}
@@ -0,0 +1,4 @@
+int scale(int x)
+{
+  return 3 * x;
+}
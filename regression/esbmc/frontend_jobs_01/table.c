@@ -0,0 +1 @@
+int table[4] = {1, 2, 3, 5};
@@ -0,0 +1,11 @@
+struct account
+{
+  int balance;
+  int limit;
+};
+
+int withdraw(struct account *a, int amount)
+{
+  a->balance -= amount;
+  return a->balance;
+}
@@ -0,0 +1,20 @@
+#include <assert.h>
+
+struct account
+{
+  int balance;
+  int limit;
+};
+
+int withdraw(struct account *a, int amount);
+
+int main()
+{
+  struct account a = {100, 50};
+
+  // withdraw() lets the balance go below the overdraft limit
+  withdraw(&a, 120);
+  withdraw(&a, 40);
+  assert(a.balance >= -a.limit);
+  return 0;
+}
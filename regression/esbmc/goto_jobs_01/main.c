@@ -0,0 +1,41 @@
+#include <assert.h>
+
+int nondet_int();
+
+// Every function has skips and unreachable code for the passes to remove
+
+int clamp(int x, int lo, int hi)
+{
+  if(x < lo)
+    return lo;
+  if(x > hi)
+    return hi;
+  return x;
+  x = 0;
+}
+
+int sign(int x)
+{
+  if(x > 0)
+    goto positive;
+  if(x < 0)
+    return -1;
+  return 0;
+positive:;
+  return 1;
+}
+
+int absolute(int x)
+{
+  return sign(x) * x;
+  ;
+}
+
+int main()
+{
+  int x = nondet_int();
+  int c = clamp(x, -50, 50);
+  assert(c >= -50 && c <= 50);
+  assert(absolute(c) >= 0);
+  return 0;
+}
@@ -0,0 +1,32 @@
+#include <assert.h>
+
+int nondet_int();
+
+int divide(int x, int y)
+{
+  if(y == 0)
+    return 0;
+  return x / y;
+  y = 1;
+}
+
+int average(int a, int b)
+{
+  while(1)
+  {
+    // The loop never runs twice
+    return divide(a + b, 2);
+  }
+  return -1;
+}
+
+int main()
+{
+  int a = nondet_int();
+  int b = nondet_int();
+  __ESBMC_assume(a >= 0 && a <= 10 && b >= 0 && b <= 10);
+
+  // Integer division rounds down: the average of 1 and 2 is 1
+  assert(2 * average(a, b) == a + b);
+  return 0;
+}
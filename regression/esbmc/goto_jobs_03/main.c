@@ -0,0 +1,21 @@
+#include <assert.h>
+
+int nondet_int();
+
+int inc(int x)
+{
+  return x + 1;
+}
+
+int dec(int x)
+{
+  return x - 1;
+}
+
+int main()
+{
+  int x = nondet_int();
+  __ESBMC_assume(x > -100 && x < 100);
+  assert(dec(inc(x)) == x);
+  return 0;
+}
@@ -0,0 +1,29 @@
+#include <assert.h>
+
+int nondet_int();
+
+struct point
+{
+  int x;
+  int y;
+};
+
+int dot(struct point a, struct point b)
+{
+  return a.x * b.x + a.y * b.y;
+}
+
+int main()
+{
+  struct point p = {nondet_int(), nondet_int()};
+  __ESBMC_assume(p.x >= 0 && p.x <= 5);
+  __ESBMC_assume(p.y >= 0 && p.y <= 5);
+
+  // The same expressions are built on every iteration
+  int sum = 0;
+  for(int i = 0; i < 4; i++)
+    sum += dot(p, p);
+
+  assert(sum == 4 * dot(p, p));
+  return 0;
+}
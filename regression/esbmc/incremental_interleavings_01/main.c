@@ -0,0 +1,31 @@
+#include <assert.h>
+#include <pthread.h>
+
+int x, y;
+
+void *t1(void *arg)
+{
+  x = 1;
+  assert(x == 1);
+  return NULL;
+}
+
+void *t2(void *arg)
+{
+  y = 2;
+  assert(y == 2);
+  return NULL;
+}
+
+int main(void)
+{
+  pthread_t id1, id2;
+
+  pthread_create(&id1, NULL, t1, NULL);
+  pthread_create(&id2, NULL, t2, NULL);
+  pthread_join(id1, NULL);
+  pthread_join(id2, NULL);
+
+  assert(x == 1 && y == 2);
+  return 0;
+}
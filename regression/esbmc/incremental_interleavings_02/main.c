@@ -0,0 +1,25 @@
+#include <assert.h>
+#include <pthread.h>
+
+int count;
+
+void *inc(void *arg)
+{
+  int tmp = count;
+  assert(tmp <= 1);
+  count = tmp + 1;
+  return NULL;
+}
+
+int main(void)
+{
+  pthread_t id1, id2;
+
+  pthread_create(&id1, NULL, inc, NULL);
+  pthread_create(&id2, NULL, inc, NULL);
+  pthread_join(id1, NULL);
+  pthread_join(id2, NULL);
+
+  assert(count == 2);
+  return 0;
+}
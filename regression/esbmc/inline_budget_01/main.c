@@ -0,0 +1,25 @@
+#include <assert.h>
+
+int nondet_int();
+
+int sq(int x)
+{
+  return x * x;
+}
+
+int norm(int x, int y)
+{
+  return sq(x) + sq(y);
+}
+
+int main()
+{
+  int a = nondet_int();
+  int b = nondet_int();
+  __ESBMC_assume(a >= 0 && a < 100 && b >= 0 && b < 100);
+
+  // norm and sq are inlined at several call sites
+  assert(norm(a, b) >= sq(a));
+  assert(norm(b, a) == norm(a, b));
+  return 0;
+}
@@ -0,0 +1,24 @@
+#include <assert.h>
+
+int nondet_int();
+
+int max(int x, int y)
+{
+  return x > y ? x : y;
+}
+
+int max3(int x, int y, int z)
+{
+  return max(max(x, y), z);
+}
+
+int main()
+{
+  int a = nondet_int();
+  int b = nondet_int();
+  int c = nondet_int();
+
+  // Wrong when c is the largest
+  assert(max3(a, b, c) == max(a, b));
+  return 0;
+}
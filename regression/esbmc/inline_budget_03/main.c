@@ -0,0 +1,21 @@
+#include <assert.h>
+
+int nondet_int();
+
+int step(int x)
+{
+  if(x % 2 == 0)
+    return x / 2;
+  return 3 * x + 1;
+}
+
+int main()
+{
+  int x = nondet_int();
+  __ESBMC_assume(x > 0 && x < 1000);
+
+  // Far more than the budget once every call is inlined
+  x = step(step(step(step(step(step(step(step(x))))))));
+  assert(x > 0);
+  return 0;
+}
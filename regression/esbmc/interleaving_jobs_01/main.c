@@ -0,0 +1,36 @@
+#include <assert.h>
+#include <pthread.h>
+
+int balance = 100;
+pthread_mutex_t m;
+
+void *deposit(void *arg)
+{
+  pthread_mutex_lock(&m);
+  balance += 10;
+  pthread_mutex_unlock(&m);
+  return NULL;
+}
+
+void *withdraw(void *arg)
+{
+  pthread_mutex_lock(&m);
+  if(balance >= 50)
+    balance -= 50;
+  pthread_mutex_unlock(&m);
+  return NULL;
+}
+
+int main(void)
+{
+  pthread_t id1, id2;
+
+  pthread_mutex_init(&m, NULL);
+  pthread_create(&id1, NULL, deposit, NULL);
+  pthread_create(&id2, NULL, withdraw, NULL);
+  pthread_join(id1, NULL);
+  pthread_join(id2, NULL);
+
+  assert(balance == 60);
+  return 0;
+}
@@ -0,0 +1,31 @@
+#include <assert.h>
+#include <pthread.h>
+
+int x;
+
+void *twice(void *arg)
+{
+  x = 1;
+  x = x + 1;
+  return NULL;
+}
+
+void *ten(void *arg)
+{
+  x = 10;
+  return NULL;
+}
+
+int main(void)
+{
+  pthread_t id1, id2;
+
+  pthread_create(&id1, NULL, twice, NULL);
+  pthread_create(&id2, NULL, ten, NULL);
+  pthread_join(id1, NULL);
+  pthread_join(id2, NULL);
+
+  // x is 11 when ten runs between the two writes of twice
+  assert(x == 2 || x == 10);
+  return 0;
+}
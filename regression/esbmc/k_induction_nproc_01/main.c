@@ -0,0 +1,18 @@
+#include <assert.h>
+
+unsigned int nondet_uint();
+
+int main()
+{
+  unsigned int n = nondet_uint();
+  __ESBMC_assume(n <= 6);
+
+  unsigned int left = n, done = 0;
+  while(left > 0)
+  {
+    --left;
+    ++done;
+  }
+  assert(done == n);
+  return 0;
+}
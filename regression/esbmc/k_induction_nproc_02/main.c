@@ -0,0 +1,14 @@
+#include <assert.h>
+
+int main()
+{
+  int fuel = 4, steps = 0;
+  while(fuel > 0)
+  {
+    fuel -= 1;
+    steps += 1;
+  }
+  // Off by one: the tank empties after four steps
+  assert(steps != 4);
+  return 0;
+}
@@ -0,0 +1,18 @@
+#include <assert.h>
+
+unsigned int nondet_uint();
+
+int main()
+{
+  unsigned int n = nondet_uint();
+  __ESBMC_assume(n <= 3);
+
+  // Only the forward condition can prove this, once k covers every
+  // iteration
+  unsigned int sum = 0;
+  for(unsigned int i = 0; i < n; i++)
+    sum += i;
+
+  assert(sum <= 3);
+  return 0;
+}
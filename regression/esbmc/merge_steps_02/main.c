@@ -0,0 +1,10 @@
+#include <assert.h>
+
+int main()
+{
+  // The base case only finds this once k reaches the fourth iteration
+  for(unsigned int i = 0; i < 5; i++)
+    assert(i != 3);
+
+  return 0;
+}
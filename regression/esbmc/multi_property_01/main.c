@@ -0,0 +1,23 @@
+#include <assert.h>
+
+unsigned int nondet_uint();
+
+int main()
+{
+  unsigned int k = nondet_uint();
+  __ESBMC_assume(k > 0 && k <= 10);
+
+  unsigned int a[4];
+  for(unsigned int i = 0; i < 4; i++)
+  {
+    a[i] = i * k;
+    assert(a[i] >= i);
+  }
+
+  assert(a[3] == 3 * k);
+
+  unsigned int x = nondet_uint();
+  __ESBMC_assume(x < 100);
+  assert(x * x < 10000);
+  return 0;
+}
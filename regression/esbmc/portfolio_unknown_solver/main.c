@@ -0,0 +1,8 @@
+#include <assert.h>
+
+int main()
+{
+  // Never reached: the solver list is rejected first
+  assert(0);
+  return 0;
+}
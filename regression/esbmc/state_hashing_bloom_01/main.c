@@ -0,0 +1,38 @@
+#include <assert.h>
+#include <pthread.h>
+
+int a, b, c;
+
+void *set_a(void *arg)
+{
+  a = 1;
+  return NULL;
+}
+
+void *set_b(void *arg)
+{
+  b = 2;
+  return NULL;
+}
+
+void *set_c(void *arg)
+{
+  c = 3;
+  return NULL;
+}
+
+int main(void)
+{
+  pthread_t id1, id2, id3;
+
+  // Every order of the three writes ends up in the same states
+  pthread_create(&id1, NULL, set_a, NULL);
+  pthread_create(&id2, NULL, set_b, NULL);
+  pthread_create(&id3, NULL, set_c, NULL);
+  pthread_join(id1, NULL);
+  pthread_join(id2, NULL);
+  pthread_join(id3, NULL);
+
+  assert(a + b + c == 6);
+  return 0;
+}
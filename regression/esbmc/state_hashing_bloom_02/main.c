@@ -0,0 +1,30 @@
+#include <assert.h>
+#include <pthread.h>
+
+int turn;
+
+void *first(void *arg)
+{
+  turn = 1;
+  return NULL;
+}
+
+void *second(void *arg)
+{
+  turn = 2;
+  return NULL;
+}
+
+int main(void)
+{
+  pthread_t id1, id2;
+
+  pthread_create(&id1, NULL, first, NULL);
+  pthread_create(&id2, NULL, second, NULL);
+  pthread_join(id1, NULL);
+  pthread_join(id2, NULL);
+
+  // Wrong when second runs before first
+  assert(turn == 2);
+  return 0;
+}
@@ -0,0 +1,18 @@
+int nondet_int();
+
+int unused(int x)
+{
+  return x - 1;
+}
+
+int inc(int x)
+{
+  return x + 1;
+}
+
+int main()
+{
+  int x = nondet_int();
+  assert(inc(x) > x);
+  return 0;
+}
@@ -0,0 +1,24 @@
+int nondet_int();
+
+int unused_twice(int x)
+{
+  return 2 * x;
+}
+
+int unused(int x)
+{
+  return unused_twice(x) + 1;
+}
+
+int inc(int x)
+{
+  return x + 1;
+}
+
+int main()
+{
+  int x = nondet_int();
+  __ESBMC_assume(x < 100);
+  assert(inc(x) > x);
+  return 0;
+}
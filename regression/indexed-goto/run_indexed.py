@@ -0,0 +1,60 @@
+#!/usr/bin/env python3
+
+# Writes each test case with c2goto --indexed, verifies the binary with
+# esbmc --binary, and checks the output against the test.desc regexes. The
+# functions main doesn't call must not be read: fewer function bodies have
+# to be loaded than the binary holds.
+#
+# Usage: run_indexed.py <c2goto> <esbmc> <directory of test cases>
+
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+
+def run_case(c2goto, esbmc, case_dir):
+    with open(os.path.join(case_dir, "test.desc")) as fp:
+        lines = [line.strip() for line in fp]
+    test_file, test_args, regexes = lines[1], lines[2].split(), lines[3:]
+
+    with tempfile.TemporaryDirectory() as tmp:
+        binary = os.path.join(tmp, "main.goto")
+        subprocess.run(
+            [c2goto, "--indexed", os.path.join(case_dir, test_file),
+             "--output", binary], check=True)
+        proc = subprocess.run(
+            [esbmc, binary, "--binary", binary] + test_args,
+            stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    output = proc.stdout.decode()
+
+    for regex in regexes:
+        if regex and not re.search(regex, output, re.MULTILINE):
+            return "expected to find '{}' in:\n{}".format(regex, output)
+
+    loaded = re.search(r"^Read ([0-9]+) of ([0-9]+) function bodies$",
+                       output, re.MULTILINE)
+    if loaded is None:
+        return "no function body count in:\n" + output
+    if int(loaded.group(1)) >= int(loaded.group(2)):
+        return "every function body was read: " + loaded.group(0)
+    return None
+
+
+def main():
+    c2goto, esbmc, base = sys.argv[1:4]
+    failed = False
+    for case in sorted(os.listdir(base)):
+        case_dir = os.path.join(base, case)
+        if not os.path.isdir(case_dir):
+            continue
+        error = run_case(c2goto, esbmc, case_dir)
+        if error:
+            print("{}: {}".format(case, error))
+            failed = True
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
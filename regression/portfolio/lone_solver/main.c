@@ -0,0 +1,13 @@
+#include <assert.h>
+
+int nondet_int();
+
+int main()
+{
+  int x = nondet_int();
+  __ESBMC_assume(x > -100 && x < 100);
+
+  int y = x < 0 ? -x : x;
+  assert(y >= 0 && y < 100);
+  return 0;
+}
@@ -0,0 +1,15 @@
+#include <assert.h>
+
+unsigned int nondet_uint();
+
+int main()
+{
+  unsigned int a = nondet_uint();
+  unsigned int b = nondet_uint();
+  __ESBMC_assume(a > 1 && a < 100);
+  __ESBMC_assume(b > 1 && b < 100);
+
+  // 391 is 17 * 23
+  assert(a * b != 391);
+  return 0;
+}
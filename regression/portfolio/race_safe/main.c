@@ -0,0 +1,16 @@
+#include <assert.h>
+
+unsigned int nondet_uint();
+
+int main()
+{
+  unsigned int a = nondet_uint();
+  unsigned int b = nondet_uint();
+  __ESBMC_assume(a < 1000 && b < 1000);
+
+  unsigned int sum = a + b;
+  unsigned int prod = a * b;
+  assert(sum >= a && sum >= b);
+  assert(prod < 1000000);
+  return 0;
+}
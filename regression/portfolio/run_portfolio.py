@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+
+# Runs esbmc on each test case and checks the output against the test.desc
+# regexes. Every solver given to --portfolio-solvers must have reported or
+# been cancelled, and a winner announced; a single solver must not be raced
+# at all.
+#
+# Usage: run_portfolio.py <esbmc> <directory of test cases>
+
+import os
+import re
+import subprocess
+import sys
+
+
+def run_case(esbmc, case_dir):
+    with open(os.path.join(case_dir, "test.desc")) as fp:
+        lines = [line.strip() for line in fp]
+    test_file, test_args, regexes = lines[1], lines[2].split(), lines[3:]
+
+    proc = subprocess.run(
+        [esbmc, test_file] + test_args, cwd=case_dir,
+        stdout=subprocess.PIPE, stderr=subprocess.STDOUT)
+    output = proc.stdout.decode()
+
+    for regex in regexes:
+        if regex and not re.search(regex, output, re.MULTILINE):
+            return "expected to find '{}' in:\n{}".format(regex, output)
+
+    solvers = test_args[test_args.index("--portfolio-solvers") + 1].split(",")
+    raced = re.findall(r"^Solver (\w+): ", output, re.MULTILINE)
+    winner = re.search(r"^Portfolio winner: (\w+)$", output, re.MULTILINE)
+    if len(solvers) == 1:
+        if raced or winner:
+            return "a lone solver was raced:\n" + output
+    elif sorted(raced) != sorted(solvers) or winner is None:
+        return "expected {} to race in:\n{}".format(solvers, output)
+    return None
+
+
+def main():
+    esbmc, base = sys.argv[1:3]
+    failed = False
+    for case in sorted(os.listdir(base)):
+        case_dir = os.path.join(base, case)
+        if not os.path.isdir(case_dir):
+            continue
+        error = run_case(esbmc, case_dir)
+        if error:
+            print("{}: {}".format(case, error))
+            failed = True
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
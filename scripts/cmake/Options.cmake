@@ -37,8 +37,10 @@ option(ENABLE_CVC4 "Use CVC4 solver (default: OFF)" OFF)
 #############################
 option(ENABLE_LIBM "Use libm from c2goto (default: ON)" ON)
 option(ENABLE_FUZZER "Add fuzzing targets (default: OFF)" OFF)
+option(ENABLE_BENCHMARKS "Add microbenchmark targets, run by hand (default: OFF)" OFF)
 option(ENABLE_CLANG_TIDY "Activate clang tidy analysis (default: OFF)" OFF)
 option(ENABLE_CSMITH "Add csmith Tests (default: OFF) (depends: ENABLE_REGRESSION)" OFF)
+option(ENABLE_THREADED_GOTO_PASSES "Make irep reference counts atomic, so that --goto-jobs can use several threads (default: OFF)" OFF)
 
 #############################
 # CMake extra Vars
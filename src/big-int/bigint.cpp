@@ -283,7 +283,7 @@ inline void BigInt::reallocate(unsigned digits)
 {
   if(digits > size)
   {
-    if(size)
+    if(on_heap())
       delete[] digit;
     size = adjust_size(digits);
     digit = new onedig_t[size];
@@ -296,14 +296,14 @@ inline void BigInt::resize(unsigned digits)
   if(digits > size)
   {
     onedig_t *old_digit = digit;
-    unsigned old_size = size;
+    bool old_on_heap = on_heap();
     size = adjust_size(digits);
     digit = new onedig_t[size];
 
     if(old_digit != nullptr)
     {
       memcpy(digit, old_digit, length * sizeof(onedig_t));
-      if(old_size)
+      if(old_on_heap)
         delete[] old_digit;
     }
   }
@@ -343,6 +343,37 @@ inline void digit_set(ullong_t ul, onedig_t d[small], unsigned &l)
   }
 }
 
+// Inverse of digit_set(): l must be at most small.
+inline ullong_t digit_get(onedig_t const *d, unsigned l)
+{
+  ullong_t ul = 0;
+  while(l > 0)
+    ul = ul << single_bits | d[--l];
+  return ul;
+}
+
+// Machine arithmetic on magnitudes, returning true when the result doesn't
+// fit into an ullong_t.
+inline bool ullong_add_overflow(ullong_t a, ullong_t b, ullong_t &r)
+{
+#ifdef __GNUC__
+  return __builtin_add_overflow(a, b, &r);
+#else
+  r = a + b;
+  return r < a;
+#endif
+}
+
+inline bool ullong_mul_overflow(ullong_t a, ullong_t b, ullong_t &r)
+{
+#ifdef __GNUC__
+  return __builtin_mul_overflow(a, b, &r);
+#else
+  r = a * b;
+  return a != 0 && r / a != b;
+#endif
+}
+
 void BigInt::assign(ullong_t ul)
 {
   positive = true;
@@ -366,7 +397,7 @@ void BigInt::assign(llong_t l)
 
 BigInt::~BigInt()
 {
-  if(size > 0)
+  if(on_heap())
   {
     memset(digit, 0, size * sizeof digit[0]); // Crypto-paranoia.
     delete[] digit;
@@ -379,80 +410,81 @@ BigInt::BigInt(onedig_t *dig, unsigned len, bool pos)
 }
 
 BigInt::BigInt()
-  : size(adjust_size(small)),
-    length(0),
-    digit(new onedig_t[size]),
-    positive(true)
+  : size(inline_digits), length(0), digit(local), positive(true)
 {
 }
 
 BigInt::BigInt(signed long int n)
-  : size(adjust_size(small)), length(0), digit(new onedig_t[size])
+  : size(inline_digits), length(0), digit(local)
 {
   assign(llong_t(n));
 }
 
 BigInt::BigInt(unsigned long int n)
-  : size(adjust_size(small)), length(0), digit(new onedig_t[size])
+  : size(inline_digits), length(0), digit(local)
 {
   assign(ullong_t(n));
 }
 
 BigInt::BigInt(int n)
-  : size(adjust_size(small)), length(0), digit(new onedig_t[size])
+  : size(inline_digits), length(0), digit(local)
 {
   assign(llong_t(n));
 }
 
 BigInt::BigInt(unsigned u)
-  : size(adjust_size(small)), length(0), digit(new onedig_t[size])
+  : size(inline_digits), length(0), digit(local)
 {
   assign(ullong_t(u));
 }
 
 BigInt::BigInt(llong_t l)
-  : size(adjust_size(small)), length(0), digit(new onedig_t[size])
+  : size(inline_digits), length(0), digit(local)
 {
   assign(l);
 }
 
 BigInt::BigInt(ullong_t ul)
-  : size(adjust_size(small)), length(0), digit(new onedig_t[size])
+  : size(inline_digits), length(0), digit(local)
 {
   assign(ul);
 }
 
 BigInt::BigInt(BigInt const &y)
-  : size(adjust_size(y.length)),
+  : size(y.length <= inline_digits ? unsigned(inline_digits)
+                                   : adjust_size(y.length)),
     length(y.length),
-    digit(new onedig_t[size]),
+    digit(y.length <= inline_digits ? local : new onedig_t[size]),
     positive(y.positive)
 {
   memcpy(digit, y.digit, length * sizeof(onedig_t));
 }
 
-BigInt::BigInt(BigInt &&y) : BigInt()
+BigInt::BigInt(BigInt &&y) noexcept : BigInt()
 {
   swap(y);
 }
 
 BigInt::BigInt(char const *s, onedig_t b)
-  : size(adjust_size(small)),
-    length(0),
-    digit(new onedig_t[size]),
-    positive(true)
+  : size(inline_digits), length(0), digit(local), positive(true)
 {
   scan(s, b);
 }
 
 BigInt &BigInt::operator=(BigInt const &y)
 {
-  BigInt copy(y);
-  swap(copy);
+  // Reuse the digits we have if they're long enough.
+  if(this != &y)
+  {
+    reallocate(y.length);
+    memcpy(digit, y.digit, y.length * sizeof(onedig_t));
+    length = y.length;
+    positive = y.positive;
+  }
   return *this;
 }
 
-BigInt &BigInt::operator=(BigInt &&y)
+BigInt &BigInt::operator=(BigInt &&y) noexcept
 {
   swap(y);
   return *this;
@@ -708,7 +740,24 @@ int BigInt::compare(ullong_t b) const
 
 int BigInt::compare(llong_t b) const
 {
-  return compare(BigInt(b));
+  if(b >= 0)
+    return compare(ullong_t(b));
+
+  if(positive)
+    return 1;
+
+  // Both are negative, the greater magnitude is the smaller number.
+  onedig_t dig[small];
+  unsigned len;
+  digit_set(-ullong_t(b), dig, len);
+
+  if(length < len)
+    return 1;
+
+  if(length > len)
+    return -1;
+
+  return -digit_cmp(digit, dig, len);
 }
 
 int BigInt::compare(BigInt const &b) const
@@ -724,6 +773,34 @@ int BigInt::compare(BigInt const &b) const
 // Auxiliary method for all adding and subtracting.
 void BigInt::add(onedig_t const *dig, unsigned len, bool pos)
 {
+  // When both magnitudes fit into an ullong_t, use machine arithmetic
+  // unless the sum overflows.
+  if(length <= small && len <= small)
+  {
+    ullong_t a = digit_get(digit, length);
+    ullong_t b = digit_get(dig, len);
+    ullong_t r;
+    if(positive != pos)
+    {
+      // The greater operand determines the sign of the result.
+      if(a >= b)
+        r = a - b;
+      else
+      {
+        r = b - a;
+        positive = pos;
+      }
+    }
+    else if(ullong_add_overflow(a, b, r))
+      goto slow;
+
+    digit_set(r, digit, length);
+    if(length == 0)
+      positive = true;
+    return;
+  }
+
+slow:
   // Make sure the result fits into this, even with carry.
   resize((length > len ? length : len) + 1);
 
@@ -774,6 +851,16 @@ void BigInt::add(onedig_t const *dig, unsigned len, bool pos)
 // Auxiliary method for multiplication.
 void BigInt::mul(onedig_t const *dig, unsigned len, bool pos)
 {
+  ullong_t r;
+  if(
+    length <= small && len <= small &&
+    !ullong_mul_overflow(digit_get(digit, length), digit_get(dig, len), r))
+  {
+    digit_set(r, digit, length);
+    positive = length == 0 || positive == pos;
+    return;
+  }
+
   if(len < 2)
   {
     // Handle small dig/len operand efficiently.
@@ -816,21 +903,21 @@ void BigInt::mul(onedig_t const *dig, unsigned len, bool pos)
   else
   {
     // Get a new string of digits for the result.
-    unsigned old_size = size;
+    bool old_on_heap = on_heap();
     size = adjust_size(length + len);
-    onedig_t *r = new onedig_t[size];
+    onedig_t *p = new onedig_t[size];
 
     // The first parameter pair defines the outer loop which should
     // be the shorter.
     if(length < len)
-      digit_mul(digit, length, dig, len, r);
+      digit_mul(digit, length, dig, len, p);
     else
-      digit_mul(dig, len, digit, length, r);
+      digit_mul(dig, len, digit, length, p);
 
     // Replace digit string of this with result.
-    if(old_size)
+    if(old_on_heap)
       delete[] digit;
-    digit = r;
+    digit = p;
     length += len;
     adjust();
   }
@@ -128,11 +128,26 @@ public:
     small = sizeof(ullong_t) / sizeof(onedig_t)
   };
 
+  // Number of digits kept inside the object itself. Enough for the product
+  // of two numbers that fit in an ullong_t, so that most values never need
+  // a digit vector on the heap.
+  enum
+  {
+    inline_digits = 2 * small
+  };
+
 private:
   unsigned size;   // Length of digit vector.
   unsigned length; // Used places in digit vector.
-  onedig_t *digit; // Least significant first.
+  onedig_t *digit; // Least significant first. Either local or on the heap.
   bool positive;   // Signed magnitude representation.
+  onedig_t local[inline_digits];
+
+  // Whether digit is ours to delete[].
+  bool on_heap() const
+  {
+    return size > 0 && digit != local;
+  }
 
   // Create or resize this.
   inline void allocate(unsigned digits);
@@ -168,11 +183,11 @@ public:
   BigInt(llong_t) _fast;
   BigInt(ullong_t) _fast;
   BigInt(BigInt const &) _fast;
-  BigInt(BigInt &&) _fast;
+  BigInt(BigInt &&) noexcept _fast;
   BigInt(char const *, onedig_t = 10) _fast;
 
   BigInt &operator=(BigInt const &) _fast;
-  BigInt &operator=(BigInt &&) _fast;
+  BigInt &operator=(BigInt &&) noexcept _fast;
 
   // Input conversion from text.
 
@@ -337,12 +352,24 @@ public:
   // Not part of original BigInt.
   void setPower2(unsigned exponent) _fast;
 
-  void swap(BigInt &other)
+  void swap(BigInt &other) noexcept
   {
+    bool this_local = digit == local;
+    bool other_local = other.digit == other.local;
     std::swap(other.size, size);
     std::swap(other.length, length);
     std::swap(other.digit, digit);
     std::swap(other.positive, positive);
+
+    // Inline digits have to move along with the rest of the number.
+    if(this_local || other_local)
+    {
+      std::swap(other.local, local);
+      if(this_local)
+        other.digit = other.local;
+      if(other_local)
+        digit = local;
+    }
   }
 };
 
@@ -1,5 +1,7 @@
+#include <c2goto/cprover_library.h>
 #include <fstream>
 #include <goto-programs/goto_convert_functions.h>
+#include <goto-programs/indexed_goto_binary.h>
 #include <goto-programs/write_goto_binary.h>
 #include <langapi/language_ui.h>
 #include <langapi/mode.h>
@@ -15,6 +17,7 @@ const struct opt_templ c2goto_options[] = {{0, "16", switc, ""},
                                            {0, "fixedbv", switc, ""},
                                            {0, "floatbv", switc, ""},
                                            {0, "output", string, ""},
+                                           {0, "indexed", switc, ""},
                                            {'I', "", string, ""},
                                            {'D', "", string, ""},
                                            {0, "", switc, ""}};
@@ -47,12 +50,34 @@ public:
     std::ofstream out(
       cmdline.getval("output"), std::ios::out | std::ios::binary);
 
+    // Indexed binaries carry the function bodies, to be loaded lazily
+    if(cmdline.isset("indexed"))
+    {
+      // Set up the entry point as esbmc does: readers only load the bodies
+      // it can reach
+      if(final())
+        return 1;
+
+      optionst options;
+      goto_convert(context, options, goto_functions, ui_message_handler);
+
+      if(write_indexed_goto_binary(out, context, goto_functions))
+      {
+        std::cerr << "Failed to write indexed goto binary" << std::endl;
+        return 1;
+      }
+
+      return 0;
+    }
+
     if(write_goto_binary(out, context, goto_functions))
     {
       std::cerr << "Failed to write C library to binary obj" << std::endl;
       return 1;
     }
 
+    write_cprover_library_deps(out, context);
+
     return 0;
   }
 };
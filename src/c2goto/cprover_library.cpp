@@ -6,23 +6,18 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
-extern "C"
-{
-#include <unistd.h>
-
-#ifdef _WIN32
-#include <windows.h>
-#include <io.h>
-#undef small // MinGW header workaround
-#endif
-}
-
 #include <c2goto/cprover_library.h>
+#include <cstdint>
 #include <cstdlib>
-#include <fstream>
-#include <goto-programs/read_goto_binary.h>
+#include <iterator>
+#include <goto-programs/read_bin_goto_object.h>
+#include <istream>
+#include <streambuf>
+#include <unordered_map>
 #include <util/c_link.h>
 #include <util/config.h>
+#include <util/irep_serialization.h>
+#include <vector>
 
 #ifndef NO_CPROVER_LIBRARY
 
@@ -133,6 +128,30 @@ void ingest_symbol(
   deps.erase(name);
 }
 
+void write_cprover_library_deps(std::ostream &out, const contextt &context)
+{
+  std::multimap<irep_idt, irep_idt> deps;
+  context.foreach_operand([&deps](const symbolt &s) {
+    generate_symbol_deps(s.id, s.value, deps);
+    generate_symbol_deps(s.id, s.type, deps);
+  });
+
+  std::vector<irep_idt> names;
+  for(auto it = deps.begin(); it != deps.end();
+      it = deps.upper_bound(it->first))
+    names.push_back(it->first);
+
+  write_long(out, names.size());
+  for(const irep_idt &name : names)
+  {
+    auto range = deps.equal_range(name);
+    write_string(out, name.as_string());
+    write_long(out, std::distance(range.first, range.second));
+    for(auto it = range.first; it != range.second; it++)
+      write_string(out, it->second.as_string());
+  }
+}
+
 #ifdef NO_CPROVER_LIBRARY
 void add_cprover_library(
   contextt &context __attribute__((unused)),
@@ -142,20 +161,27 @@ void add_cprover_library(
 
 #else
 
+/* Read-only stream buffer over the library embedded in the executable */
+class clib_streambuft : public std::streambuf
+{
+public:
+  clib_streambuft(uint8_t *data, uint64_t size)
+  {
+    char *begin = reinterpret_cast<char *>(data);
+    setg(begin, begin, begin + size);
+  }
+};
+
 void add_cprover_library(contextt &context, message_handlert &message_handler)
 {
   if(config.ansi_c.lib == configt::ansi_ct::libt::LIB_NONE)
     return;
 
-  contextt new_ctx, store_ctx;
-  goto_functionst goto_functions;
+  contextt store_ctx;
   std::multimap<irep_idt, irep_idt> symbol_deps;
   std::list<irep_idt> to_include;
-  char symname_buffer[288];
-  FILE *f;
   uint8_t **this_clib_ptrs;
   uint64_t size;
-  int fd;
 
   if(config.ansi_c.word_size == 32)
   {
@@ -200,36 +226,49 @@ void add_cprover_library(contextt &context, message_handlert &message_handler)
     abort();
   }
 
-#ifndef _WIN32
-  sprintf(symname_buffer, "/tmp/ESBMC_XXXXXX");
-  fd = mkstemp(symname_buffer);
-  close(fd);
-#else
-  char tmpdir[256];
-  GetTempPath(sizeof(tmpdir), tmpdir);
-  GetTempFileName(tmpdir, "bmc", 0, symname_buffer);
-#endif
-  f = fopen(symname_buffer, "wb");
-  if(fwrite(this_clib_ptrs[0], size, 1, f) != 1)
+  // Read the library straight out of the buffer it is embedded in
+  clib_streambuft buf(this_clib_ptrs[0], size);
+  std::istream infile(&buf);
+
+  irep_serializationt::ireps_containert ic;
+  std::vector<irept> lib_symbols;
+  if(read_bin_goto_symbols(
+       infile, "<built-in-library>", ic, lib_symbols, message_handler))
   {
-    std::cerr << "Couldn't manipulate internal C library" << std::endl;
+    std::cerr << "Couldn't read internal C library" << std::endl;
     abort();
   }
-  fclose(f);
-
-  std::ifstream infile(symname_buffer, std::ios::in | std::ios::binary);
-  read_goto_binary(infile, new_ctx, goto_functions, message_handler);
-  infile.close();
-#ifndef _WIN32
-  unlink(symname_buffer);
-#else
-  DeleteFile(symname_buffer);
-#endif
 
-  new_ctx.foreach_operand([&symbol_deps](const symbolt &s) {
-    generate_symbol_deps(s.id, s.value, symbol_deps);
-    generate_symbol_deps(s.id, s.type, symbol_deps);
-  });
+  /* Symbols are only converted from their irep once we know they're needed,
+   * which for most programs is a small part of the library. */
+  std::unordered_map<irep_idt, const irept *, irep_id_hash> lib_index;
+  for(const irept &s : lib_symbols)
+    lib_index.emplace(s.name(), &s);
+
+  // c2goto stores the dependencies between library symbols after the (empty)
+  // function section; older libraries have to have them worked out here.
+  irep_serializationt irepconverter(ic);
+  if(
+    irepconverter.read_long(infile) == 0 &&
+    infile.peek() != std::char_traits<char>::eof())
+  {
+    unsigned int num_names = irepconverter.read_long(infile);
+    for(unsigned int i = 0; i < num_names; i++)
+    {
+      irep_idt name = irepconverter.read_string(infile);
+      unsigned int num_deps = irepconverter.read_long(infile);
+      for(unsigned int j = 0; j < num_deps; j++)
+        symbol_deps.emplace(name, irepconverter.read_string(infile));
+    }
+  }
+  else
+  {
+    for(const irept &s : lib_symbols)
+    {
+      generate_symbol_deps(s.name(), s.symvalue(), symbol_deps);
+      generate_symbol_deps(s.name(), s.type(), symbol_deps);
+    }
+  }
 
   // Add two hacks; we migth use either pthread_mutex_lock or the checked
   // variety; so if one version is used, pull in the other too.
@@ -250,24 +289,31 @@ void add_cprover_library(contextt &context, message_handlert &message_handler)
    * haven't pulled in, then pull them in. We finish when we've made a pass
    * that adds no new symbols. */
 
-  new_ctx.foreach_operand(
-    [&context, &store_ctx, &symbol_deps, &to_include](const symbolt &s) {
-      const symbolt *symbol = context.find_symbol(s.id);
-      if(symbol != nullptr && symbol->value.is_nil())
-      {
-        store_ctx.add(s);
-        ingest_symbol(s.id, symbol_deps, to_include);
-      }
-    });
+  for(const irept &irep : lib_symbols)
+  {
+    const symbolt *symbol = context.find_symbol(irep.name());
+    if(symbol != nullptr && symbol->value.is_nil())
+    {
+      symbolt s;
+      s.from_irep(irep);
+      store_ctx.add(s);
+      ingest_symbol(s.id, symbol_deps, to_include);
+    }
+  }
 
   for(std::list<irep_idt>::const_iterator nameit = to_include.begin();
       nameit != to_include.end();
       nameit++)
   {
-    symbolt *s = new_ctx.find_symbol(*nameit);
-    if(s != nullptr)
+    auto it = lib_index.find(*nameit);
+    if(it != lib_index.end())
     {
-      store_ctx.add(*s);
+      if(store_ctx.find_symbol(*nameit) == nullptr)
+      {
+        symbolt s;
+        s.from_irep(*it->second);
+        store_ctx.add(s);
+      }
       ingest_symbol(*nameit, symbol_deps, to_include);
     }
   }
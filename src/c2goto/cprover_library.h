@@ -9,9 +9,15 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_ANSI_C_CPROVER_LIBRARY_H
 #define CPROVER_ANSI_C_CPROVER_LIBRARY_H
 
+#include <ostream>
 #include <util/context.h>
 #include <util/message.h>
 
 void add_cprover_library(contextt &context, message_handlert &message_handler);
 
+/* Write the index of which symbols each library symbol refers to. c2goto
+ * appends it to the library's goto binary, so that add_cprover_library
+ * doesn't have to walk the whole library to work it out. */
+void write_cprover_library_deps(std::ostream &out, const contextt &context);
+
 #endif
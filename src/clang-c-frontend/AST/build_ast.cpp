@@ -18,34 +18,62 @@
 #include <clang/Frontend/CompilerInstance.h>
 #include <clang/Frontend/CompilerInvocation.h>
 #include <clang/Frontend/FrontendActions.h>
+#include <clang/Frontend/PrecompiledPreamble.h>
 #include <clang/Frontend/TextDiagnosticPrinter.h>
 #include <clang/Lex/PreprocessorOptions.h>
 #include <clang/Tooling/Tooling.h>
 #include <llvm/Option/ArgList.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/Path.h>
 #pragma GCC diagnostic pop
 #pragma GCC diagnostic pop
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <unistd.h>
+#include <util/crypto_hash.h>
 
-std::unique_ptr<clang::ASTUnit> buildASTs(
-  const std::string &intrinsics,
-  const std::vector<std::string> &compiler_args)
+static std::string hash_file(const std::string &path)
 {
-  // Create virtual file system to add clang's headers
-  llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> OverlayFileSystem(
-    new llvm::vfs::OverlayFileSystem(llvm::vfs::getRealFileSystem()));
+  auto buffer = llvm::MemoryBuffer::getFile(path);
+  if(!buffer)
+    return "";
 
-  llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> InMemoryFileSystem(
-    new llvm::vfs::InMemoryFileSystem);
-  OverlayFileSystem->pushOverlay(InMemoryFileSystem);
+  crypto_hash hash;
+  hash.ingest((*buffer)->getBufferStart(), (*buffer)->getBufferSize());
+  hash.fin();
+  return hash.to_string();
+}
 
-  llvm::IntrusiveRefCntPtr<clang::FileManager> Files(
-    new clang::FileManager(clang::FileSystemOptions(), OverlayFileSystem));
+// Write a file under a temporary name and move it in place, so that other
+// processes sharing the cache never see it half written
+static bool write_file_atomically(
+  const std::string &path,
+  const std::string &contents)
+{
+  std::string tmp = path + "." + std::to_string(getpid());
+  {
+    std::ofstream out(tmp, std::ios::binary);
+    out << contents;
+    if(!out.good())
+      return true;
+  }
+
+  return std::rename(tmp.c_str(), path.c_str()) != 0;
+}
 
+/* Run the driver on compiler_args, and return the arguments of the single
+ * cc1 job it builds. */
+static std::vector<std::string> get_cc1_args(
+  const std::vector<std::string> &compiler_args,
+  clang::DiagnosticsEngine *Diagnostics,
+  clang::DiagnosticOptions &DiagOpts,
+  clang::FileManager &Files)
+{
   // Create everything needed to create a CompilerInvocation,
   // copied from ToolInvocation::run
-  llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> DiagOpts =
-    new clang::DiagnosticOptions();
-
   std::unique_ptr<llvm::opt::OptTable> Opts(
     clang::driver::createDriverOptTable());
 
@@ -59,22 +87,13 @@ std::unique_ptr<clang::ASTUnit> buildASTs(
     MissingArgIndex,
     MissingArgCount);
 
-  clang::ParseDiagnosticArgs(*DiagOpts, ParsedArgs);
-
-  clang::TextDiagnosticPrinter *DiagnosticPrinter =
-    new clang::TextDiagnosticPrinter(llvm::errs(), &*DiagOpts);
-
-  clang::DiagnosticsEngine *Diagnostics = new clang::DiagnosticsEngine(
-    llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs>(new clang::DiagnosticIDs()),
-    &*DiagOpts,
-    DiagnosticPrinter,
-    false);
+  clang::ParseDiagnosticArgs(DiagOpts, ParsedArgs);
 
   const std::unique_ptr<clang::driver::Driver> Driver(new clang::driver::Driver(
     "clang-tool",
     llvm::sys::getDefaultTargetTriple(),
     *Diagnostics,
-    &Files->getVirtualFileSystem()));
+    &Files.getVirtualFileSystem()));
   Driver->setTitle("clang_based_tool");
 
   // Since the input might only be virtual, don't check whether it exists.
@@ -85,25 +104,335 @@ std::unique_ptr<clang::ASTUnit> buildASTs(
   const clang::driver::JobList &Jobs = Compilation->getJobs();
   assert(Jobs.size() == 1);
 
-  const llvm::opt::ArgStringList *const CC1Args = &Jobs.begin()->getArguments();
+  // Show the invocation, with -v.
+  if(ParsedArgs.hasArg(clang::driver::options::OPT_v))
+  {
+    llvm::errs() << "clang Invocation:\n";
+    Compilation->getJobs().Print(llvm::errs(), "\n", true);
+    llvm::errs() << "\n";
+  }
+
+  std::vector<std::string> CC1Args;
+  for(const char *Arg : Jobs.begin()->getArguments())
+    CC1Args.emplace_back(Arg);
+
+  return CC1Args;
+}
+
+/* The header search directories in the cc1 arguments, roughly in the order
+ * they're searched: -iquote, -I, system directories, then -idirafter. */
+static std::vector<std::string>
+get_search_dirs(const std::vector<std::string> &cc1_args)
+{
+  static const std::vector<std::vector<std::string>> groups = {
+    {"-iquote"},
+    {"-I"},
+    {"-isystem",
+     "-cxx-isystem",
+     "-internal-isystem",
+     "-internal-externc-isystem"},
+    {"-idirafter"}};
+
+  std::vector<std::string> dirs;
+  for(const std::vector<std::string> &flags : groups)
+  {
+    for(unsigned int i = 0; i < cc1_args.size(); i++)
+    {
+      for(const std::string &flag : flags)
+      {
+        std::string dir;
+        if(cc1_args[i] == flag && i + 1 < cc1_args.size())
+          dir = cc1_args[++i];
+        else if(flag == "-I" && cc1_args[i].compare(0, 2, "-I") == 0)
+          dir = cc1_args[i].substr(2);
+        else
+          continue;
+
+        while(dir.size() > 1 && dir.back() == '/')
+          dir.pop_back();
+        if(!dir.empty())
+          dirs.push_back(dir);
+        break;
+      }
+    }
+  }
+
+  return dirs;
+}
+
+static llvm::opt::ArgStringList
+to_arg_list(const std::vector<std::string> &args)
+{
+  llvm::opt::ArgStringList list;
+  for(const std::string &arg : args)
+    list.push_back(arg.c_str());
+  return list;
+}
+
+/* Precompile the prelude of the main file: the intrinsics, followed by the
+ * preprocessor directives (mostly #includes) the file starts with. The PCH
+ * is stored in cache_dir under a hash of the compiler arguments and of the
+ * prelude itself, next to the list of files it was built from and the hash
+ * of their contents. Headers found in a search directory also record the
+ * paths, in the directories searched before it, that didn't exist. The PCH
+ * is rebuilt whenever any of those files changes or any of those paths
+ * appears, which would change what the includes resolve to.
+ * Returns the path to the PCH, or an empty string if it couldn't be built. */
+static std::string get_prelude_pch(
+  const std::string &cache_dir,
+  const std::string &intrinsics,
+  const std::string &preamble,
+  const std::vector<std::string> &compiler_args)
+{
+  const std::string &main_file = compiler_args.back();
+
+  std::string prelude = intrinsics + "\n" + preamble;
+
+  /* Quoted includes of the prelude look in the main file's directory first,
+   * so two files with the same prelude in different directories can't share
+   * a PCH. Key on where that directory really is, not on how it was named. */
+  llvm::SmallString<256> abs_main_dir(llvm::sys::path::parent_path(main_file));
+  llvm::sys::fs::make_absolute(abs_main_dir);
+  std::string key_dir = abs_main_dir.str().str();
+
+  crypto_hash key;
+  std::string version = CLANG_VERSION_STRING;
+  key.ingest(version.c_str(), version.size() + 1);
+  for(unsigned int i = 0; i + 1 < compiler_args.size(); i++)
+    key.ingest(compiler_args[i].c_str(), compiler_args[i].size() + 1);
+  key.ingest(key_dir.c_str(), key_dir.size() + 1);
+  key.ingest(prelude.c_str(), prelude.size());
+  key.fin();
+
+  std::string base = cache_dir + "/" + key.to_string();
+  std::string pch_path = base + ".pch";
+  std::string deps_path = base + ".deps";
+  std::string prelude_path = base + ".h";
+
+  // Reuse the PCH if none of the files it was built from changed, and the
+  // includes would still find the same files. Absent paths have a "-" hash.
+  std::ifstream deps_in(deps_path);
+  if(deps_in && std::ifstream(pch_path))
+  {
+    bool valid = true;
+    std::string hash, path;
+    while(valid && deps_in >> hash && std::getline(deps_in >> std::ws, path))
+    {
+      if(hash == "-")
+        valid = !llvm::sys::fs::exists(path);
+      else
+        valid = hash_file(path) == hash;
+    }
+
+    if(valid)
+      return pch_path;
+  }
+
+  if(llvm::sys::fs::create_directories(cache_dir))
+    return "";
+
+  /* The prelude is a real file, so that locations in it can be looked up
+   * later on. Includes are made relative to the main file's directory, as
+   * they would be in the main file. */
+  if(write_file_atomically(prelude_path, prelude))
+    return "";
+
+  std::vector<std::string> pch_args;
+  for(unsigned int i = 0; i + 1 < compiler_args.size(); i++)
+  {
+    pch_args.push_back(compiler_args[i]);
+
+    // Precompiling needs the header flavour of the language
+    if(compiler_args[i] == "-x" && i + 2 < compiler_args.size())
+      pch_args.push_back(compiler_args[++i] + "-header");
+  }
+  pch_args.push_back("-iquote");
+  pch_args.push_back(llvm::sys::path::parent_path(main_file).str());
+  pch_args.push_back(prelude_path);
+
+  llvm::IntrusiveRefCntPtr<clang::FileManager> Files(new clang::FileManager(
+    clang::FileSystemOptions(), llvm::vfs::getRealFileSystem()));
+
+  llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> DiagOpts =
+    new clang::DiagnosticOptions();
+  llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs> DiagIDs(
+    new clang::DiagnosticIDs());
+  llvm::IntrusiveRefCntPtr<clang::DiagnosticsEngine> Diagnostics(
+    new clang::DiagnosticsEngine(
+      DiagIDs,
+      &*DiagOpts,
+      new clang::TextDiagnosticPrinter(llvm::errs(), &*DiagOpts),
+      true));
+
+  std::vector<std::string> CC1Args =
+    get_cc1_args(pch_args, &*Diagnostics, *DiagOpts, *Files);
+
+  std::shared_ptr<clang::CompilerInvocation> Invocation(
+    clang::tooling::newInvocation(&*Diagnostics, to_arg_list(CC1Args)));
+
+  std::string tmp_pch = pch_path + "." + std::to_string(getpid());
+  Invocation->getFrontendOpts().OutputFile = tmp_pch;
+
+  clang::CompilerInstance Compiler;
+  Compiler.setInvocation(Invocation);
+  Compiler.setFileManager(&*Files);
+  Compiler.createDiagnostics();
+
+  clang::GeneratePCHAction Action;
+  if(
+    !Compiler.ExecuteAction(Action) ||
+    Compiler.getDiagnostics().hasErrorOccurred())
+  {
+    std::remove(tmp_pch.c_str());
+    return "";
+  }
+
+  /* Record every file that went into the PCH, and their current contents.
+   * The source manager is gone by now, but the file manager still knows
+   * every file that was opened. */
+  llvm::SmallVector<const clang::FileEntry *, 64> entries;
+  Files->GetUniqueIDMapping(entries);
+
+  // Quoted includes in the main file look next to it first
+  std::vector<std::string> search_dirs = get_search_dirs(CC1Args);
+  std::string main_dir = llvm::sys::path::parent_path(main_file).str();
+  if(!main_dir.empty())
+    search_dirs.insert(search_dirs.begin(), main_dir);
+
+  std::set<std::string> absent;
+  std::ostringstream deps;
+  for(const clang::FileEntry *entry : entries)
+  {
+    if(entry == nullptr)
+      continue;
+
+    std::string path = entry->getName().str();
+    std::string hash = hash_file(path);
+    if(hash.empty())
+    {
+      std::remove(tmp_pch.c_str());
+      return "";
+    }
+
+    deps << hash << " " << path << "\n";
+
+    // Whatever this was included as, from any directory it's under, it would
+    // be found somewhere else if it appeared in an earlier directory
+    for(unsigned int i = 0; i < search_dirs.size(); i++)
+    {
+      const std::string &dir = search_dirs[i];
+      if(path.compare(0, dir.size() + 1, dir + "/") != 0)
+        continue;
+
+      std::string name = path.substr(dir.size() + 1);
+      for(unsigned int j = 0; j < i; j++)
+      {
+        std::string other = search_dirs[j] + "/" + name;
+        if(!llvm::sys::fs::exists(other))
+          absent.insert(other);
+      }
+    }
+  }
+
+  for(const std::string &path : absent)
+    deps << "- " << path << "\n";
+
+  if(
+    write_file_atomically(deps_path, deps.str()) ||
+    std::rename(tmp_pch.c_str(), pch_path.c_str()) != 0)
+  {
+    std::remove(tmp_pch.c_str());
+    return "";
+  }
+
+  return pch_path;
+}
+
+std::unique_ptr<clang::ASTUnit> buildASTs(
+  const std::string &intrinsics,
+  const std::vector<std::string> &compiler_args,
+  const std::string &pch_cache_dir)
+{
+  // Create virtual file system to add clang's headers
+  llvm::IntrusiveRefCntPtr<llvm::vfs::OverlayFileSystem> OverlayFileSystem(
+    new llvm::vfs::OverlayFileSystem(llvm::vfs::getRealFileSystem()));
+
+  llvm::IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> InMemoryFileSystem(
+    new llvm::vfs::InMemoryFileSystem);
+  OverlayFileSystem->pushOverlay(InMemoryFileSystem);
+
+  llvm::IntrusiveRefCntPtr<clang::FileManager> Files(
+    new clang::FileManager(clang::FileSystemOptions(), OverlayFileSystem));
+
+  llvm::IntrusiveRefCntPtr<clang::DiagnosticOptions> DiagOpts =
+    new clang::DiagnosticOptions();
+
+  clang::TextDiagnosticPrinter *DiagnosticPrinter =
+    new clang::TextDiagnosticPrinter(llvm::errs(), &*DiagOpts);
+
+  clang::DiagnosticsEngine *Diagnostics = new clang::DiagnosticsEngine(
+    llvm::IntrusiveRefCntPtr<clang::DiagnosticIDs>(new clang::DiagnosticIDs()),
+    &*DiagOpts,
+    DiagnosticPrinter,
+    false);
+
+  std::vector<std::string> CC1Args =
+    get_cc1_args(compiler_args, Diagnostics, *DiagOpts, *Files);
 
 #if(CLANG_VERSION_MAJOR >= 4)
   std::shared_ptr<clang::CompilerInvocation> Invocation(
-    clang::tooling::newInvocation(Diagnostics, *CC1Args));
+    clang::tooling::newInvocation(Diagnostics, to_arg_list(CC1Args)));
 #else
-  auto Invocation = clang::tooling::newInvocation(Diagnostics, *CC1Args);
+  auto Invocation =
+    clang::tooling::newInvocation(Diagnostics, to_arg_list(CC1Args));
 #endif
 
-  // Show the invocation, with -v.
-  if(Invocation->getHeaderSearchOpts().Verbose)
+  std::string main_intrinsics = intrinsics;
+  if(!pch_cache_dir.empty())
   {
-    llvm::errs() << "clang Invocation:\n";
-    Compilation->getJobs().Print(llvm::errs(), "\n", true);
-    llvm::errs() << "\n";
+    const std::string &main_file = compiler_args.back();
+    auto buffer = llvm::MemoryBuffer::getFile(main_file);
+    if(buffer)
+    {
+      clang::PreambleBounds bounds = clang::ComputePreambleBounds(
+        *Invocation->getLangOpts(), buffer->get(), 0);
+      std::string contents = (*buffer)->getBuffer().str();
+
+      std::string pch = get_prelude_pch(
+        pch_cache_dir,
+        intrinsics,
+        contents.substr(0, bounds.Size),
+        compiler_args);
+
+      if(!pch.empty())
+      {
+        /* The main file is parsed with its prelude blanked out, keeping the
+         * line numbers of everything after it, and the PCH loaded in its
+         * place. The PCH was checked against the contents of the files it
+         * was built from and against the include lookups, their timestamps
+         * don't matter. */
+        for(unsigned int i = 0; i < bounds.Size; i++)
+          if(contents[i] != '\n')
+            contents[i] = ' ';
+
+        clang::PreprocessorOptions &PPOpts = Invocation->getPreprocessorOpts();
+        PPOpts.ImplicitPCHInclude = pch;
+        PPOpts.DisablePCHValidation = true;
+
+        // The source manager takes ownership of remapped buffers
+        PPOpts.RetainRemappedFileBuffers = false;
+        PPOpts.addRemappedFile(
+          main_file,
+          llvm::MemoryBuffer::getMemBufferCopy(contents, main_file).release());
+
+        // Already part of the PCH
+        main_intrinsics.clear();
+      }
+    }
   }
 
   // Create our custom action
-  auto action = new esbmc_action(std::move(intrinsics));
+  auto action = new esbmc_action(std::move(main_intrinsics));
 
   // Create ASTUnit
   std::unique_ptr<clang::ASTUnit> unit(
@@ -9,6 +9,7 @@
 #define CLANG_C_FRONTEND_AST_BUILD_AST_H_
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -21,8 +22,12 @@ namespace clang
 class ASTUnit;
 } // namespace clang
 
+/* Parse the file at the end of compiler_args. If pch_cache_dir is not empty,
+ * the intrinsics and the #includes the file starts with are precompiled and
+ * kept there, to be reused by later runs with the same arguments. */
 std::unique_ptr<clang::ASTUnit> buildASTs(
   const std::string &intrinsics,
-  const std::vector<std::string> &compiler_args);
+  const std::vector<std::string> &compiler_args,
+  const std::string &pch_cache_dir);
 
 #endif /* CLANG_C_FRONTEND_AST_BUILD_AST_H_ */
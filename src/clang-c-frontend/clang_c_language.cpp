@@ -198,7 +198,8 @@ bool clang_c_languaget::parse(
   std::string intrinsics = internal_additions();
 
   // Generate ASTUnit and add to our vector
-  auto AST = buildASTs(intrinsics, new_compiler_args);
+  auto AST = buildASTs(
+    intrinsics, new_compiler_args, config.options.get_option("pch-cache"));
 
   ASTs.push_back(std::move(AST));
 
@@ -43,6 +43,12 @@ public:
     return "c";
   }
 
+  // Each file is converted into its own context, and linked in afterwards
+  bool typechecks_independently() const override
+  {
+    return true;
+  }
+
   void show_parse(std::ostream &out) override;
 
   // conversion from expression into string
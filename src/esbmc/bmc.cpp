@@ -7,10 +7,16 @@ Authors: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <atomic>
 #include <csignal>
 #include <sys/types.h>
 
 #ifndef _WIN32
+#include <cerrno>
+#include <poll.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 #include <unistd.h>
 #else
 #include <windows.h>
@@ -23,6 +29,7 @@ Authors: Daniel Kroening, kroening@kroening.com
 #include <esbmc/bmc.h>
 #include <esbmc/document_subgoals.h>
 #include <fstream>
+#include <iomanip>
 #include <goto-programs/goto_loops.h>
 #include <goto-symex/build_goto_trace.h>
 #include <goto-symex/goto_trace.h>
@@ -35,10 +42,12 @@ Authors: Daniel Kroening, kroening@kroening.com
 #include <sstream>
 #include <util/i2string.h>
 #include <util/irep2.h>
+#include <util/irep2_hash_cons.h>
 #include <util/location.h>
 #include <util/message_stream.h>
 #include <util/migrate.h>
 #include <util/show_symbol_table.h>
+#include <util/simplify_cache.h>
 #include <util/time_stopping.h>
 
 bmct::bmct(
@@ -54,6 +63,17 @@ bmct::bmct(
 {
   interleaving_number = 0;
   interleaving_failed = 0;
+  trace_reported = false;
+
+  // With --smt-during-symex the formula is handed to the solver as it is
+  // built, there is no point at which the cache could save any work
+  if(
+    options.get_option("query-cache") != "" &&
+    !options.get_bool_option("smt-during-symex"))
+  {
+    query_cache =
+      std::make_unique<query_cachet>(options.get_option("query-cache"));
+  }
 
   if(options.get_bool_option("smt-during-symex"))
   {
@@ -86,7 +106,17 @@ void bmct::do_cbmc(
   std::shared_ptr<symex_target_equationt> &eq)
 {
   smt_conv->set_message_handler(message_handler);
-  eq->convert(*smt_conv.get());
+  if(incremental_conv && incremental_conv->get_solver() == smt_conv)
+  {
+    incremental_conv->convert(eq);
+
+    std::ostringstream str;
+    str << "Reused " << incremental_conv->reused_steps
+        << " encoded steps, encoded " << incremental_conv->converted_steps;
+    status(str.str());
+  }
+  else
+    eq->convert(*smt_conv.get());
 }
 
 void bmct::successful_trace()
@@ -198,6 +228,13 @@ smt_convt::resultt bmct::run_decision_procedure(
   str << "s";
   status(str.str());
 
+  if(options.get_bool_option("memstats"))
+  {
+    std::ostringstream mem;
+    smt_conv->print_memstats(mem);
+    status(mem.str());
+  }
+
   if(
     options.get_bool_option("smt-formula-too") ||
     options.get_bool_option("smt-formula-only"))
@@ -462,7 +499,16 @@ smt_convt::resultt bmct::start_bmc()
 {
   std::shared_ptr<symex_target_equationt> eq;
   smt_convt::resultt res = run(eq);
-  report_trace(res, eq);
+
+  if(options.get_bool_option("state-hashing"))
+  {
+    std::ostringstream str;
+    symex->print_state_hashing_stats(str);
+    status(str.str());
+  }
+
+  if(!trace_reported)
+    report_trace(res, eq);
   report_result(res);
   return res;
 }
@@ -475,6 +521,11 @@ smt_convt::resultt bmct::run(std::shared_ptr<symex_target_equationt> &eq)
   if(options.get_bool_option("schedule"))
     return run_thread(eq);
 
+  if(
+    options.get_option("interleaving-jobs") != "" &&
+    !options.get_bool_option("interactive-ileaves"))
+    return run_parallel_interleavings(eq);
+
   smt_convt::resultt res;
   do
   {
@@ -521,6 +572,433 @@ smt_convt::resultt bmct::run(std::shared_ptr<symex_target_equationt> &eq)
   return interleaving_failed > 0 ? smt_convt::P_SATISFIABLE : res;
 }
 
+/* Shared by every process exploring interleavings, it lives in anonymous
+ * shared memory */
+struct interleaving_boardt
+{
+  // Worker processes that may still be started
+  std::atomic<long> free_slots;
+
+  std::atomic<uint64_t> explored;
+  std::atomic<uint64_t> failed;
+
+  // Set once a bug was found, unless all the runs were asked for
+  std::atomic<bool> stop;
+
+  // Held by whichever process is writing to stdout
+  std::atomic_flag output_lock;
+};
+
+/* Stands in for std::cout's buffer in every process exploring interleavings.
+ * Output is written to stdout under the board's output lock, a flush at a
+ * time; counterexamples are printed while holding the lock throughout, so
+ * that no other process writes in the middle of one. */
+class board_outputt : public std::streambuf
+{
+public:
+  explicit board_outputt(interleaving_boardt &_board)
+    : board(_board), held(false)
+  {
+  }
+
+  void lock()
+  {
+    sync();
+    acquire();
+    held = true;
+  }
+
+  void unlock()
+  {
+    sync();
+    held = false;
+    board.output_lock.clear(std::memory_order_release);
+  }
+
+protected:
+  interleaving_boardt &board;
+  std::string buffer;
+  bool held;
+
+  void acquire()
+  {
+    while(board.output_lock.test_and_set(std::memory_order_acquire))
+      sched_yield();
+  }
+
+  int overflow(int c) override
+  {
+    if(c != EOF)
+      buffer += (char)c;
+    return c;
+  }
+
+  std::streamsize xsputn(const char *s, std::streamsize n) override
+  {
+    buffer.append(s, n);
+    return n;
+  }
+
+  int sync() override
+  {
+    if(buffer.empty())
+      return 0;
+
+    if(!held)
+      acquire();
+
+    size_t done = 0;
+    while(done < buffer.size())
+    {
+      ssize_t len =
+        write(STDOUT_FILENO, buffer.data() + done, buffer.size() - done);
+      if(len < 0 && errno == EINTR)
+        continue;
+      if(len <= 0)
+        break;
+      done += len;
+    }
+    buffer.clear();
+
+    if(!held)
+      board.output_lock.clear(std::memory_order_release);
+    return 0;
+  }
+};
+
+static bool take_slot(interleaving_boardt &board)
+{
+  long slots = board.free_slots;
+  while(slots > 0 &&
+        !board.free_slots.compare_exchange_weak(slots, slots - 1))
+    ;
+  return slots > 0;
+}
+
+/* Exit statuses of the worker processes */
+enum
+{
+  WORKER_SAFE = 0,
+  WORKER_FAILED = 1,
+  WORKER_ERROR = 2
+};
+
+static void
+merge_result(smt_convt::resultt &res, const smt_convt::resultt other)
+{
+  // A bug beats anything else; anything else beats no bug
+  if(res == smt_convt::P_SATISFIABLE || other == smt_convt::P_UNSATISFIABLE)
+    return;
+
+  if(res == smt_convt::P_UNSATISFIABLE || other == smt_convt::P_SATISFIABLE)
+    res = other;
+}
+
+smt_convt::resultt
+bmct::run_parallel_interleavings(std::shared_ptr<symex_target_equationt> &eq)
+{
+  long num_workers =
+    strtol(options.get_option("interleaving-jobs").c_str(), nullptr, 10);
+  if(num_workers == 0)
+    num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+  if(num_workers < 1)
+    num_workers = 1;
+
+  void *mem = mmap(
+    nullptr,
+    sizeof(interleaving_boardt),
+    PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_ANONYMOUS,
+    -1,
+    0);
+  if(mem == MAP_FAILED)
+  {
+    error("Shared memory creation failed");
+    return smt_convt::P_ERROR;
+  }
+
+  interleaving_boardt *board = new(mem) interleaving_boardt();
+  board->free_slots = num_workers - 1;
+  board->explored = 0;
+  board->failed = 0;
+  board->stop = false;
+  board->output_lock.clear();
+
+  std::cout.flush();
+  board_outputt output(*board);
+  std::streambuf *old_output = std::cout.rdbuf(&output);
+
+  bool all_runs = options.get_bool_option("all-runs");
+  bool is_worker = false;
+  std::vector<pid_t> children_pid;
+  smt_convt::resultt res = smt_convt::P_UNSATISFIABLE;
+
+  bool more = true;
+  while(more && !board->stop)
+  {
+    uint64_t n = ++board->explored;
+    if(n > 1)
+      std::cout << "*** Thread interleavings " << n << " ***" << std::endl;
+
+    fine_timet bmc_start = current_time();
+    smt_convt::resultt r = run_thread(eq);
+
+    if(r == smt_convt::P_SATISFIABLE)
+    {
+      ++board->failed;
+
+      if(config.options.get_bool_option("smt-model"))
+        runtime_solver->print_model();
+
+      if(config.options.get_bool_option("bidirectional"))
+        bidirectional_search(runtime_solver, eq);
+
+      // The model only exists in this process, report the trace now
+      output.lock();
+      report_trace(r, eq);
+      output.unlock();
+    }
+
+    if(r)
+    {
+      merge_result(res, r);
+      if(!all_runs)
+        board->stop = true;
+    }
+
+    fine_timet bmc_stop = current_time();
+
+    std::ostringstream str;
+    str << "BMC program time: ";
+    output_time(bmc_stop - bmc_start, str);
+    str << "s";
+    status(str.str());
+
+    more = symex->setup_next_formula();
+
+    // Hand the largest unexplored subtrees to the idle workers; whoever
+    // gets one explores it, and can share it again, as we do
+    while(more && !board->stop && take_slot(*board))
+    {
+      unsigned int depth;
+      std::vector<unsigned int> tids;
+      if(!symex->find_unexplored_switches(depth, tids))
+      {
+        ++board->free_slots;
+        break;
+      }
+
+      // Don't let the children flush our buffered output again
+      std::cout.flush();
+
+      pid_t pid = fork();
+      if(pid == -1)
+      {
+        ++board->free_slots;
+        break;
+      }
+
+      if(!pid)
+      {
+        is_worker = true;
+        children_pid.clear();
+        res = smt_convt::P_UNSATISFIABLE;
+        more = symex->keep_only_switches(depth, tids);
+        break;
+      }
+
+      symex->give_away_switches(depth, tids);
+      children_pid.push_back(pid);
+    }
+  }
+
+  // Our subtree is done, someone else may take the slot
+  ++board->free_slots;
+
+  for(pid_t pid : children_pid)
+  {
+    int status;
+    if(waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+    {
+      merge_result(res, smt_convt::P_ERROR);
+      continue;
+    }
+
+    switch(WEXITSTATUS(status))
+    {
+    case WORKER_SAFE:
+      break;
+    case WORKER_FAILED:
+      merge_result(res, smt_convt::P_SATISFIABLE);
+      break;
+    default:
+      merge_result(res, smt_convt::P_ERROR);
+      break;
+    }
+  }
+
+  if(is_worker)
+  {
+    std::cout.flush();
+    switch(res)
+    {
+    case smt_convt::P_UNSATISFIABLE:
+      _exit(WORKER_SAFE);
+    case smt_convt::P_SATISFIABLE:
+      _exit(WORKER_FAILED);
+    default:
+      _exit(WORKER_ERROR);
+    }
+  }
+
+  std::cout.flush();
+  std::cout.rdbuf(old_output);
+
+  interleaving_number = board->explored.load();
+  interleaving_failed = board->failed.load();
+  munmap(mem, sizeof(interleaving_boardt));
+
+  // Every counterexample was printed by the process that found it
+  trace_reported = res == smt_convt::P_SATISFIABLE;
+  return res;
+}
+
+smt_convt::resultt bmct::run_merged_steps(smt_convt::resultt &fc_res)
+{
+  fc_res = smt_convt::P_ERROR;
+
+  symex->options.set_option("unwind", options.get_option("unwind"));
+  symex->setup_for_new_explore();
+
+  if(options.get_bool_option("hash-cons"))
+    hash_cons_collect();
+
+  std::shared_ptr<goto_symext::symex_resultt> result;
+  try
+  {
+    result = symex->get_next_formula();
+  }
+
+  catch(std::string &error_str)
+  {
+    error(error_str);
+    return smt_convt::P_ERROR;
+  }
+
+  catch(const char *error_str)
+  {
+    error(error_str);
+    return smt_convt::P_ERROR;
+  }
+
+  catch(std::bad_alloc &)
+  {
+    std::cout << "Out of memory" << std::endl;
+    return smt_convt::P_ERROR;
+  }
+
+  std::shared_ptr<symex_target_equationt> eq =
+    std::dynamic_pointer_cast<symex_target_equationt>(result->target);
+
+  // Both steps' assertions are in the equation, so slicing keeps what
+  // either of them needs
+  if(!options.get_bool_option("no-slice"))
+    slice(eq, options.get_bool_option("slice-assumes"));
+  else
+    simple_slice(eq);
+
+  {
+    std::ostringstream str;
+    str << "Generated " << result->total_claims << " VCC(s), ";
+    str << result->remaining_claims << " remaining after simplification";
+    status(str.str());
+  }
+
+  auto report_step = [this, &eq](smt_convt::resultt res, bool base_case) {
+    options.set_option("base-case", base_case);
+    options.set_option("forward-condition", !base_case);
+    report_trace(res, eq);
+    report_result(res);
+  };
+
+  if(result->remaining_claims == 0)
+  {
+    fc_res = smt_convt::P_UNSATISFIABLE;
+    report_step(smt_convt::P_UNSATISFIABLE, true);
+    report_step(fc_res, false);
+    return smt_convt::P_UNSATISFIABLE;
+  }
+
+  auto new_solver = [this]() {
+    std::shared_ptr<smt_convt> smt_conv(create_solver_factory(
+      "", options.get_bool_option("int-encoding"), ns, options));
+    smt_conv->set_message_handler(message_handler);
+    smt_conv->set_verbosity(get_verbosity());
+    return smt_conv;
+  };
+
+  auto solve = [this](const std::string &step) {
+    fine_timet sat_start = current_time();
+    smt_convt::resultt res = runtime_solver->dec_solve();
+    fine_timet sat_stop = current_time();
+
+    std::ostringstream str;
+    str << "Runtime decision procedure (" << step << "): ";
+    output_time(sat_stop - sat_start, str);
+    str << "s";
+    status(str.str());
+    return res;
+  };
+
+  runtime_solver = new_solver();
+  fine_timet encode_start = current_time();
+  smt_astt base_case = eq->convert_merged_steps(*runtime_solver);
+  fine_timet encode_stop = current_time();
+
+  {
+    std::ostringstream str;
+    str << "Encoding to solver time: ";
+    output_time(encode_stop - encode_start, str);
+    str << "s";
+    status(str.str());
+  }
+
+  bool reuse = runtime_solver->supports_ctx();
+  if(reuse)
+    runtime_solver->push_ctx();
+
+  runtime_solver->assert_ast(base_case);
+  smt_convt::resultt bc_res = solve("base case");
+  if(bc_res == smt_convt::P_SATISFIABLE)
+  {
+    // The unwinding assertions were assumptions for this model, don't let
+    // the counterexample report them as violated
+    for(auto &SSA_step : eq->SSA_steps)
+      if(SSA_step.is_unwinding_assertion())
+        SSA_step.type = goto_trace_stept::ASSUME;
+  }
+
+  report_step(bc_res, true);
+  if(bc_res != smt_convt::P_UNSATISFIABLE)
+    return bc_res;
+
+  // Retract the base case selector. Solvers that can't are given the
+  // equation again, which still saves running symex for it.
+  if(reuse)
+    runtime_solver->pop_ctx();
+  else
+  {
+    runtime_solver = new_solver();
+    base_case = eq->convert_merged_steps(*runtime_solver);
+  }
+
+  runtime_solver->assert_ast(runtime_solver->invert_ast(base_case));
+  fc_res = solve("forward condition");
+  report_step(fc_res, false);
+
+  return bc_res;
+}
+
 void bmct::bidirectional_search(
   std::shared_ptr<smt_convt> &smt_conv,
   std::shared_ptr<symex_target_equationt> &eq)
@@ -534,7 +1012,7 @@ void bmct::bidirectional_search(
   // We'll walk list of SSA steps and look for inductive assignments
   std::vector<stack_framet> frames;
   unsigned assert_loop_number = 0;
-  for(auto ssait : eq->SSA_steps)
+  for(auto const &ssait : eq->SSA_steps)
   {
     if(ssait.is_assert() && smt_conv->l_get(ssait.cond_ast).is_false())
     {
@@ -542,7 +1020,7 @@ void bmct::bidirectional_search(
         return;
 
       // Save the location of the failed assertion
-      frames = ssait.stack_trace;
+      frames = ssait.get_stack_trace();
       assert_loop_number = ssait.loop_number;
 
       // We are not interested in instructions before the failed assertion yet
@@ -589,7 +1067,7 @@ void bmct::bidirectional_search(
     std::unordered_map<irep_idt, std::pair<expr2tc, expr2tc>, irep_id_hash>
       var_ssa_list;
 
-    for(auto ssait : eq->SSA_steps)
+    for(auto const &ssait : eq->SSA_steps)
     {
       if(ssait.loop_number == lit->get_original_loop_head()->loop_number)
         break;
@@ -655,6 +1133,11 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
 {
   std::shared_ptr<goto_symext::symex_resultt> result;
 
+  simplify_cache_clear();
+  // Equations of earlier interleavings and k steps have been dropped by now
+  if(options.get_bool_option("hash-cons"))
+    hash_cons_collect();
+
   fine_timet symex_start = current_time();
   try
   {
@@ -701,6 +1184,17 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
     status(str.str());
   }
 
+  if(options.get_bool_option("memstats"))
+  {
+    std::ostringstream cache_str;
+    simplify_cache_stats(cache_str);
+    status(cache_str.str());
+
+    std::ostringstream str;
+    eq->print_memstats(str);
+    status(str.str());
+  }
+
   if(options.get_bool_option("double-assign-check"))
     eq->check_for_duplicate_assigns();
 
@@ -763,13 +1257,80 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
       return smt_convt::P_UNSATISFIABLE;
     }
 
-    if(!options.get_bool_option("smt-during-symex"))
+    if(options.get_bool_option("multi-property"))
+      return run_multi_property(eq);
+
+    crypto_hash cache_key;
+    if(query_cache)
+    {
+      cache_key = query_cachet::hash_equation(*eq, options);
+
+      // A cached SAT verdict has no model behind it, only use it when
+      // nobody is going to ask for the counterexample
+      smt_convt::resultt cached;
+      bool need_model = !options.get_bool_option("result-only") ||
+                        options.get_bool_option("smt-model") ||
+                        options.get_bool_option("bidirectional");
+      if(
+        query_cache->lookup(cache_key, cached) &&
+        (cached == smt_convt::P_UNSATISFIABLE || !need_model))
+      {
+        status("Verdict found in the query cache");
+        return cached;
+      }
+    }
+
+    std::string solver_name;
+    if(options.get_bool_option("portfolio"))
+    {
+      std::vector<std::string> portfolio = get_portfolio();
+      if(portfolio.empty())
+      {
+        error("No solvers in the portfolio");
+        return smt_convt::P_ERROR;
+      }
+
+      // A lone solver doesn't need to race anyone, just use it here
+      if(portfolio.size() == 1)
+        solver_name = portfolio.front();
+      else
+      {
+        smt_convt::resultt res = run_portfolio(eq, portfolio, solver_name);
+        if(res != smt_convt::P_SATISFIABLE)
+          return res;
+
+        // The model only exists in the winner's process, solve again with it
+        // here so that we can build the counterexample
+      }
+    }
+
+    if(incremental_conv)
+      runtime_solver = incremental_conv->get_solver();
+    else if(!options.get_bool_option("smt-during-symex"))
     {
       runtime_solver = std::shared_ptr<smt_convt>(create_solver_factory(
-        "", options.get_bool_option("int-encoding"), ns, options));
+        solver_name, options.get_bool_option("int-encoding"), ns, options));
+
+      if(options.get_bool_option("incremental-interleavings"))
+      {
+        if(runtime_solver->supports_ctx())
+          incremental_conv =
+            std::make_unique<incremental_equation_convt>(runtime_solver);
+        else
+        {
+          warning(
+            "Solver " + runtime_solver->solver_text() +
+            " can't pop contexts, encoding every interleaving from scratch");
+          options.set_option("incremental-interleavings", false);
+        }
+      }
     }
 
-    return run_decision_procedure(runtime_solver, eq);
+    smt_convt::resultt res = run_decision_procedure(runtime_solver, eq);
+    if(query_cache)
+      query_cache->insert(cache_key, res);
+
+    return res;
   }
 
   catch(std::string &error_str)
@@ -790,3 +1351,403 @@ smt_convt::resultt bmct::run_thread(std::shared_ptr<symex_target_equationt> &eq)
     return smt_convt::P_ERROR;
   }
 }
+
+std::vector<std::string> bmct::get_portfolio() const
+{
+  std::vector<std::string> portfolio;
+  std::string names = options.get_option("portfolio-solvers");
+  if(names.empty())
+  {
+    // Every solver built in, but smtlib, which needs an external program
+    for(unsigned int i = 0; i < esbmc_num_solvers; i++)
+      if(esbmc_solvers[i].name != "smtlib")
+        portfolio.push_back(esbmc_solvers[i].name);
+  }
+  else
+  {
+    std::istringstream is(names);
+    std::string name;
+    while(std::getline(is, name, ','))
+      portfolio.push_back(name);
+  }
+
+  return portfolio;
+}
+
+smt_convt::resultt bmct::run_portfolio(
+  std::shared_ptr<symex_target_equationt> &eq,
+  const std::vector<std::string> &portfolio,
+  std::string &winner)
+{
+  struct portfolio_resultt
+  {
+    unsigned int solver;
+    smt_convt::resultt result;
+    fine_timet time;
+  };
+
+  int fds[2];
+  if(pipe(fds))
+  {
+    error("Pipe creation failed");
+    return smt_convt::P_ERROR;
+  }
+
+  // Don't let the children flush our buffered output again
+  std::cout.flush();
+
+  fine_timet start = current_time();
+  std::vector<pid_t> children_pid;
+  for(unsigned int i = 0; i < portfolio.size(); i++)
+  {
+    pid_t pid = fork();
+    if(pid == -1)
+    {
+      error("Fork failed");
+      break;
+    }
+
+    if(!pid)
+    {
+      close(fds[0]);
+
+      portfolio_resultt r = {i, smt_convt::P_ERROR, 0};
+      try
+      {
+        std::shared_ptr<smt_convt> smt_conv(create_solver_factory(
+          portfolio[i], options.get_bool_option("int-encoding"), ns, options));
+        do_cbmc(smt_conv, eq);
+        r.result = smt_conv->dec_solve();
+      }
+      catch(...)
+      {
+        r.result = smt_convt::P_ERROR;
+      }
+      r.time = current_time() - start;
+
+      auto const len = write(fds[1], &r, sizeof(r));
+      assert(len == sizeof(r) && "short write");
+      (void)len; //ndebug
+      _exit(0);
+    }
+
+    children_pid.push_back(pid);
+  }
+  close(fds[1]);
+
+  std::vector<bool> reported(children_pid.size(), false);
+  smt_convt::resultt res = smt_convt::P_ERROR;
+  portfolio_resultt r;
+  while(read(fds[0], &r, sizeof(r)) == sizeof(r))
+  {
+    reported[r.solver] = true;
+
+    std::ostringstream str;
+    str << "Solver " << portfolio[r.solver] << ": ";
+    switch(r.result)
+    {
+    case smt_convt::P_SATISFIABLE:
+      str << "SAT";
+      break;
+    case smt_convt::P_UNSATISFIABLE:
+      str << "UNSAT";
+      break;
+    default:
+      str << "error";
+      break;
+    }
+    str << " in ";
+    output_time(r.time, str);
+    str << "s";
+    status(str.str());
+
+    if(
+      r.result == smt_convt::P_SATISFIABLE ||
+      r.result == smt_convt::P_UNSATISFIABLE)
+    {
+      res = r.result;
+      winner = portfolio[r.solver];
+      break;
+    }
+  }
+  close(fds[0]);
+
+  // Cancel the rest of the race
+  fine_timet stop = current_time();
+  for(unsigned int i = 0; i < children_pid.size(); i++)
+  {
+    kill(children_pid[i], SIGKILL);
+    waitpid(children_pid[i], nullptr, 0);
+
+    if(reported[i])
+      continue;
+
+    std::ostringstream str;
+    str << "Solver " << portfolio[i] << ": cancelled after ";
+    output_time(stop - start, str);
+    str << "s";
+    status(str.str());
+  }
+
+  if(res == smt_convt::P_ERROR)
+    error("No solver in the portfolio produced an answer");
+  else
+    status("Portfolio winner: " + winner);
+
+  return res;
+}
+
+/* Only keep the assertions generated by the claim at pc, every other one is
+ * ignored when converting the equation. Returns the previous ignore flags
+ * of the assertions, for restore_claims. */
+static std::vector<bool>
+keep_claim(symex_target_equationt &eq, goto_programt::const_targett pc)
+{
+  std::vector<bool> ignored;
+  for(auto &SSA_step : eq.SSA_steps)
+  {
+    if(!SSA_step.is_assert())
+      continue;
+
+    ignored.push_back(SSA_step.ignore);
+    if(SSA_step.source.pc != pc)
+      SSA_step.ignore = true;
+  }
+
+  return ignored;
+}
+
+static void
+restore_claims(symex_target_equationt &eq, const std::vector<bool> &ignored)
+{
+  unsigned int i = 0;
+  for(auto &SSA_step : eq.SSA_steps)
+    if(SSA_step.is_assert())
+      SSA_step.ignore = ignored[i++];
+}
+
+smt_convt::resultt
+bmct::run_multi_property(std::shared_ptr<symex_target_equationt> &eq)
+{
+  // A claim is an assertion of the program, it may have been unwound into
+  // any number of assertions of the equation
+  struct claimt
+  {
+    goto_programt::const_targett pc;
+    std::string description;
+    smt_convt::resultt result;
+    fine_timet time;
+  };
+
+  std::vector<claimt> claims;
+  std::map<const goto_programt::instructiont *, unsigned int> claim_map;
+  for(const auto &SSA_step : eq->SSA_steps)
+  {
+    if(!SSA_step.is_assert() || SSA_step.ignore)
+      continue;
+
+    if(claim_map.emplace(&*SSA_step.source.pc, claims.size()).second)
+    {
+      std::string description = id2string(SSA_step.comment);
+      claimt claim = {SSA_step.source.pc,
+                      description.empty() ? "assertion" : description,
+                      smt_convt::P_ERROR,
+                      0};
+      claims.push_back(claim);
+    }
+  }
+
+  const std::string &nproc = options.get_option("multi-property-nproc");
+  long num_workers = nproc != "" ? strtol(nproc.c_str(), nullptr, 10)
+                                 : sysconf(_SC_NPROCESSORS_ONLN);
+  if(num_workers < 1)
+    num_workers = 1;
+
+  {
+    std::ostringstream str;
+    str << "Checking " << claims.size() << " claim(s) on " << num_workers
+        << " worker process(es)";
+    status(str.str());
+  }
+
+  struct claim_resultt
+  {
+    smt_convt::resultt result;
+    fine_timet time;
+  };
+
+  // Don't let the children flush our buffered output again
+  std::cout.flush();
+
+  // Each running worker is identified by its pid, and reports back on its
+  // own pipe. Its pipe becomes readable once it has written its result or
+  // died, and only then is it reaped: other children of this process, such
+  // as solver processes, are never waited for here.
+  std::map<pid_t, std::pair<unsigned int, int>> running;
+  unsigned int next_claim = 0;
+  while(next_claim < claims.size() || !running.empty())
+  {
+    while(next_claim < claims.size() && running.size() < (size_t)num_workers)
+    {
+      int fds[2];
+      if(pipe(fds))
+      {
+        error("Pipe creation failed");
+        break;
+      }
+
+      pid_t pid = fork();
+      if(pid == -1)
+      {
+        close(fds[0]);
+        close(fds[1]);
+        error("Fork failed");
+        break;
+      }
+
+      if(!pid)
+      {
+        close(fds[0]);
+
+        fine_timet start = current_time();
+        claim_resultt r = {smt_convt::P_ERROR, 0};
+        try
+        {
+          keep_claim(*eq, claims[next_claim].pc);
+
+          std::shared_ptr<smt_convt> smt_conv(create_solver_factory(
+            "", options.get_bool_option("int-encoding"), ns, options));
+          do_cbmc(smt_conv, eq);
+          r.result = smt_conv->dec_solve();
+        }
+        catch(...)
+        {
+          r.result = smt_convt::P_ERROR;
+        }
+        r.time = current_time() - start;
+
+        auto const len = write(fds[1], &r, sizeof(r));
+        assert(len == sizeof(r) && "short write");
+        (void)len; //ndebug
+        _exit(0);
+      }
+
+      close(fds[1]);
+      running[pid] = std::make_pair(next_claim++, fds[0]);
+    }
+
+    // Nothing could be started, and nothing is left to wait for
+    if(running.empty())
+      break;
+
+    std::vector<pollfd> fds;
+    std::vector<pid_t> pids;
+    for(const auto &it : running)
+    {
+      fds.push_back({it.second.second, POLLIN, 0});
+      pids.push_back(it.first);
+    }
+
+    if(poll(fds.data(), fds.size(), -1) < 0)
+    {
+      if(errno == EINTR)
+        continue;
+
+      error("Waiting for the workers failed");
+      break;
+    }
+
+    for(unsigned int i = 0; i < fds.size(); i++)
+    {
+      if(fds[i].revents == 0)
+        continue;
+
+      auto it = running.find(pids[i]);
+      claimt &claim = claims[it->second.first];
+      claim_resultt r;
+      if(read(it->second.second, &r, sizeof(r)) == sizeof(r))
+      {
+        claim.result = r.result;
+        claim.time = r.time;
+      }
+      close(it->second.second);
+      waitpid(pids[i], nullptr, 0);
+      running.erase(it);
+    }
+  }
+
+  // Only left if waiting failed, their claims stay errors
+  for(const auto &it : running)
+  {
+    kill(it.first, SIGKILL);
+    waitpid(it.first, nullptr, 0);
+    close(it.second.second);
+  }
+
+  // Print the verdict of every claim, in the order of the equation
+  unsigned int failed = 0, errors = 0;
+  std::cout << "\nClaim  Verdict     Time        Location\n";
+  for(unsigned int i = 0; i < claims.size(); i++)
+  {
+    const claimt &claim = claims[i];
+
+    std::string verdict;
+    switch(claim.result)
+    {
+    case smt_convt::P_SATISFIABLE:
+      verdict = "FAILED";
+      failed++;
+      break;
+    case smt_convt::P_UNSATISFIABLE:
+      verdict = "SUCCESSFUL";
+      break;
+    default:
+      verdict = "ERROR";
+      errors++;
+      break;
+    }
+
+    std::ostringstream time;
+    output_time(claim.time, time);
+    time << "s";
+
+    std::cout << std::left << std::setw(7) << i + 1 << std::setw(12) << verdict
+              << std::setw(12) << time.str() << claim.pc->location << "\n"
+              << std::setw(31) << "" << claim.description << "\n";
+  }
+  std::cout << std::right << std::endl;
+
+  {
+    std::ostringstream str;
+    str << claims.size() << " claim(s): " << failed << " failed, "
+        << claims.size() - failed - errors << " successful, " << errors
+        << " error(s)";
+    status(str.str());
+  }
+
+  if(failed == 0)
+    return errors ? smt_convt::P_ERROR : smt_convt::P_UNSATISFIABLE;
+
+  if(options.get_bool_option("result-only"))
+    return smt_convt::P_SATISFIABLE;
+
+  // The models only existed in the workers, solve the first failing claim
+  // again so that its counterexample can be built
+  for(const auto &claim : claims)
+  {
+    if(claim.result != smt_convt::P_SATISFIABLE)
+      continue;
+
+    std::vector<bool> ignored = keep_claim(*eq, claim.pc);
+    runtime_solver = std::shared_ptr<smt_convt>(create_solver_factory(
+      "", options.get_bool_option("int-encoding"), ns, options));
+    smt_convt::resultt res = run_decision_procedure(runtime_solver, eq);
+
+    // The other claims were converted with a false guard, so they still
+    // stay out of the counterexample
+    restore_claims(*eq, ignored);
+    return res;
+  }
+
+  return smt_convt::P_SATISFIABLE;
+}
@@ -9,11 +9,13 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_CBMC_BMC_H
 #define CPROVER_CBMC_BMC_H
 
+#include <goto-symex/query_cache.h>
 #include <goto-symex/reachability_tree.h>
 #include <goto-symex/symex_target_equation.h>
 #include <langapi/language_ui.h>
 #include <list>
 #include <map>
+#include <memory>
 #include <solvers/smt/smt_conv.h>
 #include <solvers/smtlib/smtlib_conv.h>
 #include <solvers/solve.h>
@@ -35,6 +37,13 @@ public:
 
   virtual smt_convt::resultt start_bmc();
   virtual smt_convt::resultt run(std::shared_ptr<symex_target_equationt> &eq);
+
+  /* Check the base case and the forward condition of the current bound with
+   * a single symex run. Both are solved on one solver, which is kept and
+   * switched between them when it can pop its assertions. Returns the base
+   * case verdict; the forward condition's is stored in fc_res, and is only
+   * computed when the base case found no bug. */
+  smt_convt::resultt run_merged_steps(smt_convt::resultt &fc_res);
   ~bmct() override = default;
 
   void set_ui(language_uit::uit _ui)
@@ -47,6 +56,11 @@ protected:
   namespacet ns;
   std::shared_ptr<smt_convt> runtime_solver;
   std::shared_ptr<reachability_treet> symex;
+  std::unique_ptr<query_cachet> query_cache;
+
+  // With --incremental-interleavings, converts every interleaving into
+  // runtime_solver, which is then kept from one to the next
+  std::unique_ptr<incremental_equation_convt> incremental_conv;
 
   // use gui format
   language_uit::uit ui;
@@ -85,6 +99,36 @@ protected:
     std::shared_ptr<symex_target_equationt> &eq);
 
   smt_convt::resultt run_thread(std::shared_ptr<symex_target_equationt> &eq);
+
+  /* Explore the interleavings on a pool of worker processes. Whenever a
+   * worker is idle, a busy one forks it off with the shallowest unexplored
+   * context switches of its own tree. Counterexamples are reported by the
+   * process that finds them, and the verdicts are merged back up the tree
+   * of processes. */
+  smt_convt::resultt
+  run_parallel_interleavings(std::shared_ptr<symex_target_equationt> &eq);
+
+  // Whether run() has already printed the counterexample
+  bool trace_reported;
+
+  // The solvers named by --portfolio-solvers, or every usable one by default
+  std::vector<std::string> get_portfolio() const;
+
+  /* Race the solvers on the equation, each one in its own process. Returns
+   * the first definitive answer and the name of the solver that gave it. A
+   * model can't leave the winner's process, so on P_SATISFIABLE the caller
+   * has to run the winner again to get a counterexample. */
+  smt_convt::resultt run_portfolio(
+    std::shared_ptr<symex_target_equationt> &eq,
+    const std::vector<std::string> &portfolio,
+    std::string &winner);
+
+  /* Check every claim left in the equation on its own, on a pool of worker
+   * processes, and print a table of the verdicts. Returns P_SATISFIABLE if
+   * any claim fails; unless only the result was asked for, the first failing
+   * claim is then solved again here, leaving its model in runtime_solver. */
+  smt_convt::resultt
+  run_multi_property(std::shared_ptr<symex_target_equationt> &eq);
 };
 
 #endif
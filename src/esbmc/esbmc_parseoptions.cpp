@@ -18,6 +18,7 @@ extern "C"
 #include <sys/sendfile.h>
 #endif
 
+#include <sys/mman.h>
 #include <sys/resource.h>
 #include <sys/time.h>
 #include <sys/types.h>
@@ -34,11 +35,13 @@ extern "C"
 #include <util/expr_util.h>
 #include <fstream>
 #include <goto-programs/add_race_assertions.h>
+#include <goto-programs/function_passes.h>
 #include <goto-programs/goto_check.h>
 #include <goto-programs/goto_convert_functions.h>
 #include <goto-programs/goto_inline.h>
 #include <goto-programs/goto_k_induction.h>
 #include <goto-programs/interval_analysis.h>
+#include <goto-programs/indexed_goto_binary.h>
 #include <goto-programs/loop_numbers.h>
 #include <goto-programs/read_goto_binary.h>
 #include <goto-programs/remove_skip.h>
@@ -49,9 +52,12 @@ extern "C"
 #include <langapi/languages.h>
 #include <langapi/mode.h>
 #include <memory>
+#include <new>
 #include <pointer-analysis/goto_program_dereference.h>
 #include <pointer-analysis/show_value_sets.h>
 #include <pointer-analysis/value_set_analysis.h>
+#include <solvers/solve.h>
+#include <sstream>
 #include <util/symbol.h>
 #include <sys/wait.h>
 #include <util/time_stopping.h>
@@ -60,20 +66,6 @@ extern "C"
 #include <ansi-c/c_preprocess.h>
 #endif
 
-enum PROCESS_TYPE
-{
-  BASE_CASE,
-  FORWARD_CONDITION,
-  INDUCTIVE_STEP,
-  PARENT
-};
-
-struct resultt
-{
-  PROCESS_TYPE type;
-  BigInt k;
-};
-
 #ifndef _WIN32
 void timeout_handler(int dummy __attribute__((unused)))
 {
@@ -246,6 +238,71 @@ void esbmc_parseoptionst::get_command_line_options(optionst &options)
     options.set_option("no-slice", true);
   }
 
+  if(cmdline.isset("portfolio") && cmdline.isset("smt-during-symex"))
+  {
+    std::cerr << "--portfolio can't be used with --smt-during-symex"
+              << std::endl;
+    abort();
+  }
+
+  // Each solver is created in a forked child, where a bad name would only
+  // show up as that child failing
+  if(cmdline.isset("portfolio-solvers"))
+  {
+    std::istringstream is(cmdline.getval("portfolio-solvers"));
+    std::string name;
+    while(std::getline(is, name, ','))
+    {
+      bool built = false;
+      for(unsigned int i = 0; i < esbmc_num_solvers; i++)
+        built |= esbmc_solvers[i].name == name;
+
+      if(!built)
+      {
+        std::cerr << "--portfolio-solvers: unknown solver \"" << name
+                  << "\", available solvers:" << ESBMC_AVAILABLE_SOLVERS
+                  << std::endl;
+        abort();
+      }
+    }
+  }
+
+  if(
+    cmdline.isset("multi-property") &&
+    (cmdline.isset("smt-during-symex") || cmdline.isset("portfolio")))
+  {
+    std::cerr << "--multi-property can't be used with --smt-during-symex or "
+                 "--portfolio"
+              << std::endl;
+    abort();
+  }
+
+#ifndef IREP_ATOMIC_REF_COUNT
+  // The goto passes would copy and release shared ireps on several threads
+  if(
+    cmdline.isset("goto-jobs") &&
+    strtoul(cmdline.getval("goto-jobs"), nullptr, 10) != 1)
+  {
+    std::cerr << "--goto-jobs needs ESBMC built with "
+                 "ENABLE_THREADED_GOTO_PASSES"
+              << std::endl;
+    abort();
+  }
+#endif
+
+  // Forked workers would all share the one solver, and its process if it
+  // has one
+  if(
+    cmdline.isset("incremental-interleavings") &&
+    (cmdline.isset("smt-during-symex") || cmdline.isset("portfolio") ||
+     cmdline.isset("interleaving-jobs")))
+  {
+    std::cerr << "--incremental-interleavings can't be used with "
+                 "--smt-during-symex, --portfolio or --interleaving-jobs"
+              << std::endl;
+    abort();
+  }
+
   if(cmdline.isset("smt-thread-guard") || cmdline.isset("smt-symex-guard"))
   {
     if(!cmdline.isset("smt-during-symex"))
@@ -470,33 +527,75 @@ int esbmc_parseoptionst::doit()
 
 int esbmc_parseoptionst::doit_k_induction_parallel()
 {
-  // Pipes for communication between processes
-  int forward_pipe[2], backward_pipe[2];
+  optionst opts;
+  get_command_line_options(opts);
 
-  // Process type
-  PROCESS_TYPE process_type = PARENT;
+  // Build the program once; every worker inherits it when forked
+  if(get_goto_program(opts, goto_functions))
+    return 6;
 
-  if(pipe(forward_pipe))
+  if(cmdline.isset("show-claims"))
   {
-    status("\nPipe Creation Failed, giving up.");
+    const namespacet ns(context);
+    show_claims(ns, get_ui(), goto_functions);
+    return 0;
+  }
+
+  if(set_claims(goto_functions))
+    return 7;
+
+  // Get max number of iterations
+  uint64_t max_k_step = cmdline.isset("unlimited-k-steps")
+                          ? UINT_MAX
+                          : strtoul(cmdline.getval("max-k-step"), nullptr, 10);
+
+  // Get the increment
+  unsigned k_step_inc = strtoul(cmdline.getval("k-step"), nullptr, 10);
+
+  // Get the number of worker processes, at least one per step
+  long num_workers =
+    cmdline.isset("k-induction-nproc")
+      ? strtol(cmdline.getval("k-induction-nproc"), nullptr, 10)
+      : sysconf(_SC_NPROCESSORS_ONLN);
+  if(num_workers < 3)
+    num_workers = 3;
+
+  // The board lives in anonymous shared memory, so that it is visible to all
+  // the forked workers
+  void *mem = mmap(
+    nullptr,
+    sizeof(k_induction_boardt),
+    PROT_READ | PROT_WRITE,
+    MAP_SHARED | MAP_ANONYMOUS,
+    -1,
+    0);
+  if(mem == MAP_FAILED)
+  {
+    status("\nShared memory creation failed, giving up.");
     _exit(1);
   }
 
-  if(pipe(backward_pipe))
+  k_induction_boardt *board = new(mem) k_induction_boardt();
+  board->next_k[BASE_CASE] = 1;
+  board->next_k[FORWARD_CONDITION] = 1;
+  // Don't run inductive step for k_step == 1
+  board->next_k[INDUCTIVE_STEP] = 2;
+  board->disabled[FORWARD_CONDITION] =
+    opts.get_bool_option("disable-forward-condition");
+  board->disabled[INDUCTIVE_STEP] =
+    opts.get_bool_option("disable-inductive-step");
+
+  // Workers write a byte here whenever they update the board. Once all of them
+  // have exited, the parent reads end-of-file.
+  int doorbell[2];
+  if(pipe(doorbell))
   {
     status("\nPipe Creation Failed, giving up.");
     _exit(1);
   }
 
-  /* Set file descriptor non-blocking */
-  fcntl(
-    backward_pipe[0], F_SETFL, fcntl(backward_pipe[0], F_GETFL) | O_NONBLOCK);
-
-  pid_t children_pid[3];
-  short num_p = 0;
-
-  // We need to fork 3 times: one for each step
-  for(unsigned p = 0; p < 3; ++p)
+  std::vector<pid_t> children_pid;
+  for(long w = 0; w < num_workers; ++w)
   {
     pid_t pid = fork();
 
@@ -509,525 +608,171 @@ int esbmc_parseoptionst::doit_k_induction_parallel()
     // Child process
     if(!pid)
     {
-      process_type = PROCESS_TYPE(p);
-      break;
+      close(doorbell[0]);
+      k_induction_worker(
+        opts,
+        *board,
+        PROCESS_TYPE(w % 3),
+        max_k_step,
+        k_step_inc,
+        doorbell[1]);
+      _exit(0);
     }
-    // Parent process
 
-    children_pid[p] = pid;
-    ++num_p;
+    children_pid.push_back(pid);
   }
 
-  if(process_type == PARENT && num_p != 3)
-  {
-    std::cerr << "Child processes were not created sucessfully." << std::endl;
-    abort();
-  }
+  close(doorbell[1]);
 
-  optionst opts;
+  // Sleep until either the board settles or every worker is done
+  char c;
+  while(!board->settled() && read(doorbell[0], &c, 1) > 0)
+    ;
+  close(doorbell[0]);
 
-  if(process_type != PARENT)
+  for(unsigned i = 0; i < children_pid.size(); ++i)
   {
-    // Get full set of options
-    get_command_line_options(opts);
-
-    // Generate goto functions and set claims
-    if(get_goto_program(opts, goto_functions))
-      return 6;
-
-    if(cmdline.isset("show-claims"))
-    {
-      const namespacet ns(context);
-      show_claims(ns, get_ui(), goto_functions);
-      return 0;
-    }
-
-    if(set_claims(goto_functions))
-      return 7;
+    int status;
+    if(
+      waitpid(children_pid[i], &status, WNOHANG) == children_pid[i] &&
+      WIFSIGNALED(status))
+      std::cout << "**** WARNING: k-induction worker " << i << " crashed."
+                << std::endl;
   }
 
-  // Get max number of iterations
-  BigInt max_k_step = cmdline.isset("unlimited-k-steps")
-                        ? UINT_MAX
-                        : strtoul(cmdline.getval("max-k-step"), nullptr, 10);
+  // Cancel whatever is still running, the verdict doesn't depend on it
+  for(pid_t pid : children_pid)
+    kill(pid, SIGKILL);
+  for(pid_t pid : children_pid)
+    waitpid(pid, nullptr, 0);
 
-  // Get the increment
-  unsigned k_step_inc = strtoul(cmdline.getval("k-step"), nullptr, 10);
+  uint64_t bug_k = board->bug_k;
+  uint64_t safe_k = board->safe_k;
+  uint64_t fc_k = board->proof_k[FORWARD_CONDITION];
+  uint64_t is_k = board->proof_k[INDUCTIVE_STEP];
+  munmap(mem, sizeof(k_induction_boardt));
 
-  // All processes were created successfully
-  switch(process_type)
-  {
-  case PARENT:
+  // Check if a solution was found by the base case
+  if(bug_k != 0)
   {
-    // Communication to child processes
-    close(forward_pipe[1]);
-    close(backward_pipe[0]);
-
-    struct resultt a_result;
-    bool bc_finished = false, fc_finished = false, is_finished = false;
-    BigInt bc_solution = max_k_step, fc_solution = max_k_step,
-           is_solution = max_k_step;
-
-    // Keep reading until we find an answer
-    while(!(bc_finished && fc_finished && is_finished))
-    {
-      // Perform read and interpret the number of bytes read
-      int read_size = read(forward_pipe[0], &a_result, sizeof(resultt));
-      if(read_size != sizeof(resultt))
-      {
-        if(read_size == 0)
-        {
-          // Client hung up; continue on, but don't interpret the result.
-          ;
-        }
-        else
-        {
-          // Invalid size read.
-          std::cerr << "Short read communicating with kinduction children"
-                    << std::endl;
-          std::cerr << "Size " << read_size << ", expected " << sizeof(resultt)
-                    << std::endl;
-          abort();
-        }
-      }
-
-      // Eventually the parent process will check if the child process is alive
-
-      // Check base case process
-      if(!bc_finished)
-      {
-        int status;
-        pid_t result = waitpid(children_pid[0], &status, WNOHANG);
-        if(result == 0)
-        {
-          // Child still alive
-        }
-        else if(result == -1)
-        {
-          // Error
-        }
-        else
-        {
-          std::cout << "**** WARNING: Base case process crashed." << std::endl;
-          bc_finished = fc_finished = is_finished = true;
-        }
-      }
-
-      // Check forward condition process
-      if(!fc_finished)
-      {
-        int status;
-        pid_t result = waitpid(children_pid[1], &status, WNOHANG);
-        if(result == 0)
-        {
-          // Child still alive
-        }
-        else if(result == -1)
-        {
-          // Error
-        }
-        else
-        {
-          std::cout << "**** WARNING: Forward condition process crashed."
-                    << std::endl;
-
-          fc_finished = bc_finished = is_finished = true;
-        }
-      }
-
-      // Check inductive step process
-      if(!is_finished)
-      {
-        int status;
-        pid_t result = waitpid(children_pid[2], &status, WNOHANG);
-        if(result == 0)
-        {
-          // Child still alive
-        }
-        else if(result == -1)
-        {
-          // Error
-        }
-        else
-        {
-          std::cout << "**** WARNING: Inductive step process crashed."
-                    << std::endl;
-
-          is_finished = bc_finished = fc_finished = true;
-        }
-      }
-
-      switch(a_result.type)
-      {
-      case BASE_CASE:
-        bc_finished = true;
-        bc_solution = a_result.k;
-        break;
-
-      case FORWARD_CONDITION:
-        fc_finished = true;
-        fc_solution = a_result.k;
-        break;
-
-      case INDUCTIVE_STEP:
-        is_finished = true;
-        is_solution = a_result.k;
-        break;
-
-      default:
-        std::cerr << "Message from unrecognized k-induction child "
-                  << "process" << std::endl;
-        abort();
-      }
-
-      // If either the base case found a bug or the forward condition
-      // finds a solution, present the result
-      if(bc_finished && (bc_solution != 0) && (bc_solution != max_k_step))
-        break;
-
-      // If the either the forward condition or inductive step finds a
-      // solution, first check if base case couldn't find a bug in that code,
-      // if there is no bug, inductive step can present the result
-
-      if(fc_finished && (fc_solution != 0) && (fc_solution != max_k_step))
-      {
-        // If base case finished, then we can present the result
-        if(bc_finished)
-          break;
-
-        // Otherwise, ask base case for a solution
-
-        // Struct to keep the result
-        struct resultt r = {process_type, 0};
-
-        r.k = fc_solution;
-
-        // Write result
-        auto const len = write(backward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
-      }
-
-      if(is_finished && (is_solution != 0) && (is_solution != max_k_step))
-      {
-        // If base case finished, then we can present the result
-        if(bc_finished)
-          break;
-
-        // Otherwise, ask base case for a solution
-
-        // Struct to keep the result
-        struct resultt r = {process_type, 0};
-
-        r.k = is_solution;
-
-        // Write result
-        auto const len = write(backward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
-      }
-    }
-
-    for(int i : children_pid)
-      kill(i, SIGKILL);
-
-    // Check if a solution was found by the base case
-    if(bc_finished && (bc_solution != 0) && (bc_solution != max_k_step))
-    {
-      std::cout << std::endl
-                << "Bug found by the base case (k = " << bc_solution << ")"
-                << std::endl;
-      std::cout << "VERIFICATION FAILED" << std::endl;
-      return true;
-    }
-
-    // Check if a solution was found by the forward condition
-    if(fc_finished && (fc_solution != 0) && (fc_solution != max_k_step))
-    {
-      // We should only present the result if the base case finished
-      // and haven't crashed (if it crashed, bc_solution will be UINT_MAX
-      if(bc_finished && (bc_solution != max_k_step))
-      {
-        std::cout << std::endl
-                  << "Solution found by the forward condition; "
-                  << "all states are reachable (k = " << fc_solution << ")"
-                  << std::endl;
-        std::cout << "VERIFICATION SUCCESSFUL" << std::endl;
-        return false;
-      }
-    }
-
-    // Check if a solution was found by the inductive step
-    if(is_finished && (is_solution != 0) && (is_solution != max_k_step))
-    {
-      // We should only present the result if the base case finished
-      // and haven't crashed (if it crashed, bc_solution will be UINT_MAX
-      if(bc_finished && (bc_solution != max_k_step))
-      {
-        std::cout << std::endl
-                  << "Solution found by the inductive step "
-                  << "(k = " << is_solution << ")" << std::endl;
-        std::cout << "VERIFICATION SUCCESSFUL" << std::endl;
-        return false;
-      }
-    }
+    std::cout << std::endl
+              << "Bug found by the base case (k = " << bug_k << ")"
+              << std::endl;
+    std::cout << "VERIFICATION FAILED" << std::endl;
+    return true;
+  }
 
-    // Couldn't find a bug or a proof for the current deepth
-    std::cout << std::endl << "VERIFICATION UNKNOWN" << std::endl;
+  // Check if a solution was found by the forward condition. We can only
+  // present the result if the base case was checked up to the same k
+  if(fc_k != 0 && fc_k <= safe_k)
+  {
+    std::cout << std::endl
+              << "Solution found by the forward condition; "
+              << "all states are reachable (k = " << fc_k << ")" << std::endl;
+    std::cout << "VERIFICATION SUCCESSFUL" << std::endl;
     return false;
-    break;
   }
 
-  case BASE_CASE:
+  // Check if a solution was found by the inductive step
+  if(is_k != 0 && is_k <= safe_k)
   {
-    // Set that we are running base case
-    opts.set_option("base-case", true);
-    opts.set_option("forward-condition", false);
-    opts.set_option("inductive-step", false);
-
-    // Start communication to the parent process
-    close(forward_pipe[0]);
-    close(backward_pipe[1]);
-
-    // Struct to keep the result
-    struct resultt r = {process_type, 0};
-
-    // Run bmc and only send results in two occasions:
-    // 1. A bug was found, we send the step where it was found
-    // 2. It couldn't find a bug
-    for(BigInt k_step = 1; k_step <= max_k_step; k_step += k_step_inc)
-    {
-      bmct bmc(goto_functions, opts, context, ui_message_handler);
-      set_verbosity_msg(bmc);
-
-      bmc.options.set_option("unwind", integer2string(k_step));
-
-      std::cout << std::endl << "*** K-Induction Loop Iteration ";
-      std::cout << k_step;
-      std::cout << " ***" << std::endl;
-      std::cout << "*** Checking base case" << std::endl;
-
-      // If an exception was thrown, we should abort the process
-      int res = 1;
-      try
-      {
-        res = do_incremental_bmc(bmc, opts);
-      }
-      catch(...)
-      {
-        break;
-      }
-
-      // Send information to parent if no bug was found
-      if(res == smt_convt::P_SATISFIABLE)
-      {
-        r.k = k_step;
+    std::cout << std::endl
+              << "Solution found by the inductive step "
+              << "(k = " << is_k << ")" << std::endl;
+    std::cout << "VERIFICATION SUCCESSFUL" << std::endl;
+    return false;
+  }
 
-        // Write result
-        auto const len = write(forward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
+  // Couldn't find a bug or a proof for the current deepth
+  std::cout << std::endl << "VERIFICATION UNKNOWN" << std::endl;
+  return false;
+}
 
-        std::cout << "BASE CASE PROCESS FINISHED." << std::endl;
+void esbmc_parseoptionst::k_induction_worker(
+  optionst &opts,
+  k_induction_boardt &board,
+  PROCESS_TYPE first_step,
+  uint64_t max_k_step,
+  unsigned k_step_inc,
+  int doorbell)
+{
+  uint64_t max_inductive_step =
+    strtoul(cmdline.getval("max-inductive-step"), nullptr, 10);
 
-        return 1;
-      }
+  // Start on our own step; once it runs out of work, help the others
+  for(unsigned s = 0; s < 3 && !board.settled(); ++s)
+  {
+    PROCESS_TYPE step = PROCESS_TYPE((first_step + s) % 3);
 
-      // Check if the parent process is asking questions
+    while(!board.settled() && !board.disabled[step])
+    {
+      uint64_t k = board.next_k[step].fetch_add(k_step_inc);
+      uint64_t proof_k = board.min_proof_k();
 
-      // Perform read and interpret the number of bytes read
-      struct resultt a_result;
-      int read_size = read(backward_pipe[0], &a_result, sizeof(resultt));
-      if(read_size != sizeof(resultt))
+      if(step == BASE_CASE)
       {
-        if(read_size == 0)
-        {
-          // Client hung up; continue on, but don't interpret the result.
-          continue;
-        }
-        if(read_size == -1 && errno == EAGAIN)
-        {
-          // No data available yet
-          continue;
-        }
-        else
+        // A proof is only waiting on the base case for its own k. Check that
+        // k directly, rather than every k in between, but only once.
+        if(proof_k != 0 && k > proof_k)
         {
-          // Invalid size read.
-          std::cerr << "Short read communicating with kinduction parent"
-                    << std::endl;
-          std::cerr << "Size " << read_size << ", expected " << sizeof(resultt)
-                    << std::endl;
-          abort();
+          uint64_t none = 0;
+          if(!board.bc_target_k.compare_exchange_strong(none, proof_k))
+            break;
+          k = proof_k;
         }
       }
-
-      // We only receive messages from the parent
-      assert(a_result.type == PARENT);
-
-      // If the value being asked is greater or equal the current step,
-      // then we can stop the base case. It can be equal, because we
-      // have just checked the current value of k
-
-      if(a_result.k >= k_step)
+      else if(proof_k != 0 && k >= proof_k)
         break;
 
-      // Otherwise, we just need to check the base case for k = a_result.k
-      k_step = max_k_step = a_result.k;
-    }
-
-    // Send information to parent that a bug was not found
-    r.k = 0;
-
-    auto const len = write(forward_pipe[1], &r, sizeof(r));
-    assert(len == sizeof(r) && "short write");
-    (void)len; //ndebug
-
-    std::cout << "BASE CASE PROCESS FINISHED." << std::endl;
-    break;
-  }
-
-  case FORWARD_CONDITION:
-  {
-    // Set that we are running forward condition
-    opts.set_option("base-case", false);
-    opts.set_option("forward-condition", true);
-    opts.set_option("inductive-step", false);
-
-    // Start communication to the parent process
-    close(forward_pipe[0]);
-    close(backward_pipe[1]);
-
-    // Struct to keep the result
-    struct resultt r = {process_type, 0};
-
-    // Run bmc and only send results in two occasions:
-    // 1. A proof was found, we send the step where it was found
-    // 2. It couldn't find a proof
-    for(BigInt k_step = 2; k_step <= max_k_step; k_step += k_step_inc)
-    {
-      if(opts.get_bool_option("disable-forward-condition"))
+      if(k > max_k_step)
         break;
 
-      bmct bmc(goto_functions, opts, context, ui_message_handler);
-      set_verbosity_msg(bmc);
-
-      bmc.options.set_option("unwind", integer2string(k_step));
+      if(step == INDUCTIVE_STEP && max_inductive_step < k)
+        break;
 
       std::cout << std::endl << "*** K-Induction Loop Iteration ";
-      std::cout << k_step;
+      std::cout << k;
       std::cout << " ***" << std::endl;
-      std::cout << "*** Checking forward condition" << std::endl;
 
-      // If an exception was thrown, we should abort the process
-      int res = 1;
+      // If an exception was thrown, we give up on this step
       try
       {
-        res = do_incremental_bmc(bmc, opts);
-      }
-      catch(...)
-      {
-        break;
-      }
-
-      // Send information to parent if no bug was found
-      if(res == smt_convt::P_UNSATISFIABLE)
-      {
-        r.k = k_step;
-
-        // Write result
-        auto const len = write(forward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
-
-        std::cout << "FORWARD CONDITION PROCESS FINISHED." << std::endl;
-
-        return 0;
-      }
-    }
-
-    // Send information to parent that it couldn't prove the code
-    r.k = 0;
-
-    auto const len = write(forward_pipe[1], &r, sizeof(r));
-    assert(len == sizeof(r) && "short write");
-    (void)len; //ndebug
-
-    std::cout << "FORWARD CONDITION PROCESS FINISHED." << std::endl;
-    break;
-  }
-
-  case INDUCTIVE_STEP:
-  {
-    // Set that we are running inductive step
-    opts.set_option("base-case", false);
-    opts.set_option("forward-condition", false);
-    opts.set_option("inductive-step", true);
-
-    // Start communication to the parent process
-    close(forward_pipe[0]);
-    close(backward_pipe[1]);
-
-    // Struct to keep the result
-    struct resultt r = {process_type, 0};
-
-    // Run bmc and only send results in two occasions:
-    // 1. A proof was found, we send the step where it was found
-    // 2. It couldn't find a proof
-    for(BigInt k_step = 2; k_step <= max_k_step; k_step += k_step_inc)
-    {
-      bmct bmc(goto_functions, opts, context, ui_message_handler);
-      set_verbosity_msg(bmc);
+        switch(step)
+        {
+        case BASE_CASE:
+          if(do_base_case(opts, goto_functions, k))
+            k_induction_boardt::update_min(board.bug_k, k);
+          else
+            k_induction_boardt::update_max(board.safe_k, k);
+          break;
 
-      bmc.options.set_option("unwind", integer2string(k_step));
+        case FORWARD_CONDITION:
+          if(!do_forward_condition(opts, goto_functions, k))
+            k_induction_boardt::update_min(board.proof_k[step], k);
+          break;
 
-      std::cout << std::endl << "*** K-Induction Loop Iteration ";
-      std::cout << k_step + 1;
-      std::cout << " ***" << std::endl;
-      std::cout << "*** Checking inductive step" << std::endl;
+        case INDUCTIVE_STEP:
+          if(!do_inductive_step(opts, goto_functions, k))
+            k_induction_boardt::update_min(board.proof_k[step], k);
+          else if(opts.get_bool_option("disable-inductive-step"))
+            board.disabled[step] = true;
+          break;
 
-      // If an exception was thrown, we should abort the process
-      int res = 1;
-      try
-      {
-        res = do_incremental_bmc(bmc, opts);
+        default:
+          assert(0 && "Unknown process type.");
+        }
       }
       catch(...)
       {
-        break;
+        board.disabled[step] = true;
       }
 
-      // Send information to parent if no bug was found
-      if(res == smt_convt::P_UNSATISFIABLE)
-      {
-        r.k = k_step;
-
-        // Write result
-        auto const len = write(forward_pipe[1], &r, sizeof(r));
-        assert(len == sizeof(r) && "short write");
-        (void)len; //ndebug
-
-        std::cout << "INDUCTIVE STEP PROCESS FINISHED." << std::endl;
-
-        return res;
-      }
+      char c = 0;
+      auto const len = write(doorbell, &c, 1);
+      assert(len == 1 && "short write");
+      (void)len; //ndebug
     }
-
-    // Send information to parent that it couldn't prove the code
-    r.k = 0;
-
-    auto const len = write(forward_pipe[1], &r, sizeof(r));
-    assert(len == sizeof(r) && "short write");
-    (void)len; //ndebug
-
-    std::cout << "INDUCTIVE STEP PROCESS FINISHED." << std::endl;
-    break;
   }
-
-  default:
-    assert(0 && "Unknown process type.");
-  }
-
-  return 0;
 }
 
 int esbmc_parseoptionst::doit_k_induction()
@@ -1062,11 +807,20 @@ int esbmc_parseoptionst::doit_k_induction()
     std::cout << k_step;
     std::cout << " ***\n";
 
-    if(do_base_case(opts, goto_functions, k_step))
-      return true;
+    if(opts.get_bool_option("merge-steps"))
+    {
+      int res = do_merged_steps(opts, goto_functions, k_step);
+      if(res != -1)
+        return res;
+    }
+    else
+    {
+      if(do_base_case(opts, goto_functions, k_step))
+        return true;
 
-    if(!do_forward_condition(opts, goto_functions, k_step))
-      return false;
+      if(!do_forward_condition(opts, goto_functions, k_step))
+        return false;
+    }
 
     if(!do_inductive_step(opts, goto_functions, k_step))
       return false;
@@ -1152,6 +906,15 @@ int esbmc_parseoptionst::doit_incremental()
     std::cout << k_step;
     std::cout << " ***\n";
 
+    if(opts.get_bool_option("merge-steps"))
+    {
+      int res = do_merged_steps(opts, goto_functions, k_step);
+      if(res != -1)
+        return res;
+
+      continue;
+    }
+
     if(do_base_case(opts, goto_functions, k_step))
       return true;
 
@@ -1374,6 +1137,52 @@ int esbmc_parseoptionst::do_inductive_step(
   return true;
 }
 
+int esbmc_parseoptionst::do_merged_steps(
+  optionst &opts,
+  goto_functionst &goto_functions,
+  const BigInt &k_step)
+{
+  // Symex as the base case does, but with unwinding assertions, which the
+  // forward condition needs
+  opts.set_option("base-case", true);
+  opts.set_option("forward-condition", false);
+  opts.set_option("inductive-step", false);
+
+  opts.set_option("no-unwinding-assertions", false);
+  opts.set_option("partial-loops", false);
+
+  bmct bmc(goto_functions, opts, context, ui_message_handler);
+  set_verbosity_msg(bmc);
+  bmc.set_ui(get_ui());
+
+  bmc.options.set_option("unwind", integer2string(k_step));
+
+  // Set max number of context bounds
+  if(cmdline.isset("incremental-cb"))
+    opts.set_option("context-bound", cmdline.getval("max-context-bound"));
+
+  std::cout << "*** Checking base case and forward condition\n";
+  smt_convt::resultt fc_res;
+  smt_convt::resultt bc_res = bmc.run_merged_steps(fc_res);
+  if(bc_res == smt_convt::P_ERROR)
+    abort();
+
+  if(bc_res == smt_convt::P_SATISFIABLE)
+  {
+    std::cout << "\nBug found (k = " << k_step << ")\n";
+    return 1;
+  }
+
+  if(fc_res == smt_convt::P_UNSATISFIABLE)
+  {
+    std::cout << "\nSolution found by the forward condition; "
+              << "all states are reachable (k = " << k_step << ")\n";
+    return 0;
+  }
+
+  return -1;
+}
+
 bool esbmc_parseoptionst::set_claims(goto_functionst &goto_functions)
 {
   try
@@ -1544,6 +1353,26 @@ void esbmc_parseoptionst::preprocessing()
 
 bool esbmc_parseoptionst::read_goto_binary(goto_functionst &goto_functions)
 {
+  if(is_indexed_goto_binary(cmdline.getval("binary")))
+  {
+    // Only read the bodies of the functions the entry point can reach
+    indexed_goto_binaryt binary;
+    if(binary.open(
+         cmdline.getval("binary"),
+         context,
+         goto_functions,
+         *get_message_handler()))
+      return true;
+
+    binary.load_reachable(goto_functions.main_id(), goto_functions);
+
+    std::ostringstream str;
+    str << "Read " << binary.num_loaded() << " of " << binary.num_functions()
+        << " function bodies";
+    status(str.str());
+    return false;
+  }
+
   std::ifstream in(cmdline.getval("binary"), std::ios::binary);
 
   if(!in)
@@ -1621,21 +1450,20 @@ bool esbmc_parseoptionst::process_goto_program(
       goto_functions, ns, context, options, value_set_analysis);
 #endif
 
-    // remove skips
-    remove_skip(goto_functions);
-
-    // remove unreachable code
-    Forall_goto_functions(f_it, goto_functions)
-      remove_unreachable(f_it->second.body);
-
-    // remove skips
-    remove_skip(goto_functions);
-
-    // recalculate numbers, etc.
-    goto_functions.update();
-
-    // add loop ids
-    goto_functions.compute_loop_numbers();
+    // remove skips and unreachable code, function by function; this
+    // recalculates numbers and loop ids afterwards
+    unsigned int goto_jobs = 1;
+    if(cmdline.isset("goto-jobs"))
+      goto_jobs = strtoul(cmdline.getval("goto-jobs"), nullptr, 10);
+
+    function_passest passes(goto_jobs);
+    passes.add([](goto_functiont &f) {
+      goto_programt &body = f.body;
+      remove_skip(body, body.instructions.begin(), body.instructions.end());
+      remove_unreachable(body);
+      remove_skip(body, body.instructions.begin(), body.instructions.end());
+    });
+    passes.run(goto_functions);
 
     if(cmdline.isset("data-races-check"))
     {
@@ -1768,6 +1596,12 @@ void esbmc_parseoptionst::help()
        " --preprocess                 stop after preprocessing\n"
        " --no-inlining                disable inlining function calls\n"
        " --full-inlining              perform full inlining of function calls\n"
+       " --inline-budget nr           stop inlining calls into a function "
+       "once it grew by nr instructions\n"
+       " --inline-stats               show how much each function grew by "
+       "inlining\n"
+       " --goto-jobs nr               simplify the goto functions on nr "
+       "threads (0: one per core)\n"
        " --all-claims                 keep all claims\n"
        " --show-loops                 show the loops in the program\n"
        " --show-claims                only show claims\n"
@@ -1777,6 +1611,10 @@ void esbmc_parseoptionst::help()
        " --no-library                 disable built-in abstract C library\n"
        " --binary                     read goto program instead of source "
        "code\n"
+       " --frontend-jobs nr           parse and convert input files on nr "
+       "worker processes (0: one per core)\n"
+       " --pch-cache <dir>            precompile the headers each file "
+       "starts with, and reuse them across runs\n"
        " --little-endian              allow little-endian word-byte "
        "conversions\n"
        " --big-endian                 allow big-endian word-byte conversions\n"
@@ -1837,6 +1675,25 @@ void esbmc_parseoptionst::help()
        " --mathsat                    use MathSAT\n"
        " --cvc                        use CVC4\n"
        " --yices                      use Yices\n"
+       " --portfolio                  race all built-in solvers and use the "
+       "first answer\n"
+       " --portfolio-solvers s1,s2    set the solvers raced by --portfolio\n"
+       " --query-cache <dir>          reuse verdicts of identical VCCs cached "
+       "in dir.\n"
+       "                              Models aren't cached, so a cached "
+       "failure is\n"
+       "                              only reused with --result-only; "
+       "otherwise the\n"
+       "                              VCC is solved again to build the "
+       "counterexample\n"
+       " --multi-property             check every claim on its own and print "
+       "a verdict\n"
+       "                              for each of them\n"
+       " --multi-property-nproc nr    set number of worker processes used by "
+       "\n"
+       "                              --multi-property (default is the number "
+       "of\n"
+       "                              online cores)\n"
        " --bv                         use solver with bit-vector arithmetic\n"
        " --ir                         use solver with integer/real arithmetic\n"
        " --smtlib                     use SMT lib format\n"
@@ -1894,15 +1751,23 @@ void esbmc_parseoptionst::help()
        " --forward-condition          check the forward condition\n"
        " --inductive-step             check the inductive step\n"
        " --k-induction                prove by k-induction \n"
-       " --k-induction-parallel       prove by k-induction, running each step "
-       "on a separate\n"
-       "                              process\n"
+       " --k-induction-parallel       prove by k-induction, running the steps "
+       "on parallel\n"
+       "                              worker processes\n"
+       " --k-induction-nproc nr       set number of worker processes (default "
+       "is the\n"
+       "                              number of online cores, at least 3)\n"
        " --k-step nr                  set k increment (default is 1)\n"
        " --max-k-step nr              set max number of iteration (default is "
        "50)\n"
        " --unlimited-k-steps          set max number of iteration to UINT_MAX\n"
        " --show-cex                   print the counter-example produced by "
        "the inductive step\n"
+       " --merge-steps                check the base case and forward "
+       "condition of\n"
+       "                              each k on a single symex run and "
+       "solver; every\n"
+       "                              k is still checked from scratch\n"
 
        "\nScheduling approaches\n"
        " --schedule                   use schedule recording approach \n"
@@ -1918,9 +1783,16 @@ void esbmc_parseoptionst::help()
        "each thread \n"
        " --state-hashing              enable state-hashing, prunes duplicate "
        "states\n"
+       " --state-hashing-bloom nr     keep visited states in a bloom filter "
+       "of nr MiB, may prune unvisited states\n"
        " --no-por                     do not do partial order reduction\n"
        " --all-runs                   check all interleavings, even if a bug "
        "was already found\n"
+       " --interleaving-jobs nr       explore interleavings on nr worker "
+       "processes (0: one per core)\n"
+       " --incremental-interleavings  keep a single solver for all "
+       "interleavings, re-encoding only where they differ (best with "
+       "--no-slice)\n"
        " --initial-context-bound nr   set the initial context-bound for "
        "incremental verification (default is 2)\n"
        " --context-bound-step nr      set k context bound increment (default "
@@ -1936,6 +1808,9 @@ void esbmc_parseoptionst::help()
        " --timeout                    configure time limit, integer followed "
        "by {s,m,h}\n"
        " --memstats                   print memory usage statistics\n"
+       " --hash-cons                  share structurally equal expressions of "
+       "the\n"
+       "                              equation\n"
        " --no-simplify                do not simplify any expression\n"
        " --no-propagation             disable constant propagation\n"
        " --enable-core-dump           do not disable core dump output\n"
@@ -9,6 +9,8 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_ESBMC_PARSEOPTIONS_H
 #define CPROVER_ESBMC_PARSEOPTIONS_H
 
+#include <atomic>
+#include <cstdint>
 #include <esbmc/bmc.h>
 #include <goto-programs/goto_convert_functions.h>
 #include <langapi/language_ui.h>
@@ -19,6 +21,67 @@ Author: Daniel Kroening, kroening@kroening.com
 
 extern const struct opt_templ esbmc_options[];
 
+enum PROCESS_TYPE
+{
+  BASE_CASE,
+  FORWARD_CONDITION,
+  INDUCTIVE_STEP,
+  PARENT
+};
+
+/* Results of the parallel k-induction steps, kept in memory shared by all
+ * the worker processes. Every field is only ever updated atomically, so the
+ * workers need no lock. A k of 0 means "not found yet". */
+struct k_induction_boardt
+{
+  // Next k to hand out, per step
+  std::atomic<uint64_t> next_k[3];
+
+  // Steps with no more work, e.g. a forward condition on infinite loops
+  std::atomic<bool> disabled[3];
+
+  // Smallest k at which the base case found a bug
+  std::atomic<uint64_t> bug_k;
+
+  // Largest k at which the base case found no bug
+  std::atomic<uint64_t> safe_k;
+
+  // Smallest k proved by the forward condition and the inductive step
+  std::atomic<uint64_t> proof_k[3];
+
+  // k of a proof the base case was asked to check out of order
+  std::atomic<uint64_t> bc_target_k;
+
+  uint64_t min_proof_k() const
+  {
+    uint64_t fc = proof_k[FORWARD_CONDITION], is = proof_k[INDUCTIVE_STEP];
+    if(fc == 0 || (is != 0 && is < fc))
+      return is;
+    return fc;
+  }
+
+  // Either a bug was found, or a proof whose k the base case has covered
+  bool settled() const
+  {
+    uint64_t proof = min_proof_k();
+    return bug_k != 0 || (proof != 0 && proof <= safe_k);
+  }
+
+  static void update_min(std::atomic<uint64_t> &v, uint64_t k)
+  {
+    uint64_t cur = v;
+    while((cur == 0 || k < cur) && !v.compare_exchange_weak(cur, k))
+      ;
+  }
+
+  static void update_max(std::atomic<uint64_t> &v, uint64_t k)
+  {
+    uint64_t cur = v;
+    while(k > cur && !v.compare_exchange_weak(cur, k))
+      ;
+  }
+};
+
 class esbmc_parseoptionst : public parseoptions_baset, public language_uit
 {
 public:
@@ -42,6 +105,13 @@ protected:
 
   int doit_k_induction();
   int doit_k_induction_parallel();
+  void k_induction_worker(
+    optionst &opts,
+    k_induction_boardt &board,
+    PROCESS_TYPE first_step,
+    uint64_t max_k_step,
+    unsigned k_step_inc,
+    int doorbell);
 
   int doit_falsification();
   int doit_incremental();
@@ -62,6 +132,16 @@ protected:
     goto_functionst &goto_functions,
     const BigInt &k_step);
 
+  /* Check the base case and the forward condition of k_step together, see
+   * bmct::run_merged_steps. Nothing is kept from the previous k: symex runs
+   * from main again and a new solver is created. Returns 1 if a bug was
+   * found, 0 if the forward condition proved the program, and -1 if
+   * neither. */
+  int do_merged_steps(
+    optionst &opts,
+    goto_functionst &goto_functions,
+    const BigInt &k_step);
+
   bool read_goto_binary(goto_functionst &goto_functions);
 
   bool set_claims(goto_functionst &goto_functions);
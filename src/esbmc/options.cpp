@@ -45,6 +45,9 @@ const struct opt_templ esbmc_options[] = {
   {0, "preprocess", switc, ""},
   {0, "no-inlining", switc, ""},
   {0, "full-inlining", switc, ""},
+  {0, "inline-budget", number, ""},
+  {0, "inline-stats", switc, ""},
+  {0, "goto-jobs", number, ""},
   {0, "all-claims", switc, ""},
   {0, "show-loops", switc, ""},
   {0, "show-claims", switc, ""},
@@ -53,6 +56,8 @@ const struct opt_templ esbmc_options[] = {
   {0, "no-arch", switc, ""},
   {0, "no-library", switc, ""},
   {0, "binary", string, ""},
+  {0, "pch-cache", string, ""},
+  {0, "frontend-jobs", number, ""},
   {0, "little-endian", switc, ""},
   {0, "big-endian", switc, ""},
   {0, "16", switc, ""},
@@ -96,6 +101,11 @@ const struct opt_templ esbmc_options[] = {
   {0, "mathsat", switc, ""},
   {0, "cvc", switc, ""},
   {0, "yices", switc, ""},
+  {0, "portfolio", switc, ""},
+  {0, "portfolio-solvers", string, ""},
+  {0, "query-cache", string, ""},
+  {0, "multi-property", switc, ""},
+  {0, "multi-property-nproc", number, ""},
   {0, "bv", switc, ""},
   {0, "ir", switc, ""},
   {0, "smtlib", switc, ""},
@@ -133,9 +143,11 @@ const struct opt_templ esbmc_options[] = {
   // k-induction
   {0, "base-case", switc, ""},
   {0, "forward-condition", switc, ""},
+  {0, "merge-steps", switc, ""},
   {0, "inductive-step", switc, ""},
   {0, "k-induction", switc, ""},
   {0, "k-induction-parallel", switc, ""},
+  {0, "k-induction-nproc", number, ""},
   {0, "k-step", number, "1"},
   {0, "max-k-step", number, "50"},
   {0, "unlimited-k-steps", switc, ""},
@@ -151,8 +163,11 @@ const struct opt_templ esbmc_options[] = {
   // Concurrency checking
   {0, "context-bound", number, "-1"},
   {0, "state-hashing", switc, ""},
+  {0, "state-hashing-bloom", number, ""},
   {0, "no-por", switc, ""},
   {0, "all-runs", switc, ""},
+  {0, "interleaving-jobs", number, ""},
+  {0, "incremental-interleavings", switc, ""},
   {0, "incremental-cb", switc, ""},
   {0, "context-bound-step", number, "5"},
   {0, "max-context-bound", number, "15"},
@@ -162,6 +177,7 @@ const struct opt_templ esbmc_options[] = {
   // Miscellaneous
   {0, "memlimit", string, ""},
   {0, "memstats", switc, ""},
+  {0, "hash-cons", switc, ""},
   {0, "timeout", string, ""},
   {0, "enable-core-dump", switc, ""},
   {0, "no-simplify", switc, ""},
@@ -0,0 +1,73 @@
+/*******************************************************************\
+
+Module: Per-function passes over goto programs
+
+\*******************************************************************/
+
+#include <atomic>
+#include <exception>
+#include <goto-programs/function_passes.h>
+#include <mutex>
+#include <thread>
+
+function_passest::function_passest(unsigned int _jobs) : jobs(_jobs)
+{
+  if(jobs == 0)
+    jobs = std::thread::hardware_concurrency();
+
+  if(jobs == 0)
+    jobs = 1;
+
+#ifndef IREP_ATOMIC_REF_COUNT
+  // irept's reference counts aren't atomic in this build
+  jobs = 1;
+#endif
+}
+
+void function_passest::run(goto_functionst &goto_functions) const
+{
+  std::vector<goto_functiont *> functions;
+  functions.reserve(goto_functions.function_map.size());
+  for(auto &it : goto_functions.function_map)
+    functions.push_back(&it.second);
+
+  // Functions vary a lot in size, so they're handed out one at a time rather
+  // than split into equal ranges up front
+  std::atomic<size_t> next(0);
+  std::exception_ptr error;
+  std::mutex error_mutex;
+
+  auto worker = [&]() {
+    size_t i;
+    while((i = next++) < functions.size())
+    {
+      try
+      {
+        for(const auto &pass : passes)
+          pass(*functions[i]);
+      }
+      catch(...)
+      {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if(!error)
+          error = std::current_exception();
+        next = functions.size();
+      }
+    }
+  };
+
+  size_t num_threads = std::min<size_t>(jobs, functions.size());
+  std::vector<std::thread> threads;
+  for(size_t i = 1; i < num_threads; i++)
+    threads.emplace_back(worker);
+
+  worker();
+
+  for(auto &thread : threads)
+    thread.join();
+
+  if(error)
+    std::rethrow_exception(error);
+
+  goto_functions.update();
+}
@@ -0,0 +1,49 @@
+/*******************************************************************\
+
+Module: Per-function passes over goto programs
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_PROGRAMS_FUNCTION_PASSES_H
+#define CPROVER_GOTO_PROGRAMS_FUNCTION_PASSES_H
+
+#include <functional>
+#include <goto-programs/goto_functions.h>
+#include <vector>
+
+/** @file function_passes.h
+ *  Runs transformations that only look at, and only modify, the body of one
+ *  function. Every pass is applied to a function before moving on to the
+ *  next one, and the functions are shared out between a number of threads.
+ *
+ *  Passes must not touch anything outside the function they're given, nor
+ *  create new strings: the string table is not thread safe. Numbering that
+ *  spans functions (locations and loops) is recomputed once all functions
+ *  are done, in function_map order, so it doesn't depend on the number of
+ *  threads.
+ *
+ *  Several threads are only used when ESBMC is built with
+ *  ENABLE_THREADED_GOTO_PASSES, which makes irept's reference counts atomic.
+ */
+
+class function_passest
+{
+public:
+  typedef std::function<void(goto_functiont &)> passt;
+
+  /* jobs is the number of threads to use, 0 for one per core */
+  explicit function_passest(unsigned int jobs = 1);
+
+  void add(const passt &pass)
+  {
+    passes.push_back(pass);
+  }
+
+  void run(goto_functionst &goto_functions) const;
+
+protected:
+  unsigned int jobs;
+  std::vector<passt> passes;
+};
+
+#endif
@@ -179,6 +179,114 @@ void goto_inlinet::replace_return(
   }
 }
 
+static void hide_locations(goto_programt &dest, const locationt &new_location)
+{
+  if(new_location.is_nil())
+    return;
+
+  Forall_goto_program_instructions(it, dest)
+  {
+    // can't just copy, e.g., due to comments field
+    it->location.id(""); // not NIL
+    it->location.set_file(new_location.get_file());
+    it->location.set_line(new_location.get_line());
+    it->location.set_column(new_location.get_column());
+    it->location.set_function(new_location.get_function());
+  }
+}
+
+void goto_inlinet::get_inlined_body(
+  const irep_idt &identifier,
+  const goto_functiont &f,
+  const exprt &function,
+  bool full,
+  goto_programt &dest,
+  std::set<std::string> &funcs)
+{
+  body_cachet::const_iterator c_it = body_cache.find(identifier);
+  if(c_it != body_cache.end() && c_it->second.full == full)
+  {
+    cache_hits++;
+    dest.copy_from(c_it->second.body);
+    funcs = c_it->second.inlined_funcs;
+    return;
+  }
+
+  cache_misses++;
+
+  dest.copy_from(f.body);
+
+  assert(dest.instructions.back().is_end_function());
+  dest.instructions.back().type = LOCATION;
+
+  if(f.body.hide)
+    hide_locations(dest, function.find_location());
+
+  // Collect the functions inlined below this one on their own
+  std::set<std::string> outer_funcs;
+  outer_funcs.swap(inlined_funcs);
+  unsigned old_cuts = cut_expansions;
+
+  recursion_sett::iterator recursion_it =
+    recursion_set.insert(identifier).first;
+
+  // do this recursively
+  goto_inline_rec(dest, full);
+
+  recursion_set.erase(recursion_it);
+
+  funcs.swap(inlined_funcs);
+  inlined_funcs.swap(outer_funcs);
+  funcs.insert(identifier.as_string());
+  funcs.insert(f.inlined_funcs.begin(), f.inlined_funcs.end());
+
+  // Hidden bodies take the location of each call site before their own
+  // calls are inlined, so they can't be shared between call sites
+  if(!f.body.hide && cut_expansions == old_cuts)
+  {
+    cached_bodyt &entry = body_cache[identifier];
+    entry.full = full;
+    entry.body.clear();
+    entry.body.copy_from(dest);
+    entry.inlined_funcs = funcs;
+  }
+}
+
+void goto_inlinet::forget(const irep_idt &function)
+{
+  const std::string &name = function.as_string();
+  for(body_cachet::iterator it = body_cache.begin(); it != body_cache.end();)
+  {
+    if(it->second.inlined_funcs.count(name) != 0)
+      it = body_cache.erase(it);
+    else
+      ++it;
+  }
+}
+
+void goto_inlinet::report_expansion(
+  const irep_idt &function,
+  unsigned old_size)
+{
+  if(!options.get_bool_option("inline-stats"))
+    return;
+
+  const goto_programt &body = goto_functions.function_map[function].body;
+  str << "Inlining: " << function << " grew from " << old_size << " to "
+      << body.instructions.size() << " instructions";
+  status();
+}
+
+void goto_inlinet::report_cache()
+{
+  if(!options.get_bool_option("inline-stats"))
+    return;
+
+  str << "Inlining: " << cache_hits << " bodies reused, " << cache_misses
+      << " expanded, " << body_cache.size() << " cached";
+  status();
+}
+
 void goto_inlinet::expand_function_call(
   goto_programt &dest,
   goto_programt::targett &target,
@@ -201,6 +309,8 @@ void goto_inlinet::expand_function_call(
   // see if we are already expanding it
   if(recursion_set.find(identifier) != recursion_set.end())
   {
+    cut_expansions++;
+
     if(!full)
     {
       target++;
@@ -240,48 +350,41 @@ void goto_inlinet::expand_function_call(
 
   if(f.body_available)
   {
-    inlined_funcs.insert(identifier.as_string());
-    for(const auto &inlined_func : f.inlined_funcs)
-    {
-      inlined_funcs.insert(inlined_func);
-    }
-
-    recursion_sett::iterator recursion_it =
-      recursion_set.insert(identifier).first;
-
     goto_programt tmp2;
-    tmp2.copy_from(f.body);
-
-    assert(tmp2.instructions.back().is_end_function());
-    tmp2.instructions.back().type = LOCATION;
+    std::set<std::string> funcs;
+    get_inlined_body(identifier, f, function, full, tmp2, funcs);
 
     replace_return(tmp2, lhs, constrain);
 
     goto_programt tmp;
     parameter_assignments(
-      tmp2.instructions.front().location, f.type, arguments, tmp);
+      f.body.instructions.front().location, f.type, arguments, tmp);
+    if(f.body.hide)
+      hide_locations(tmp, function.find_location());
     tmp.destructive_append(tmp2);
 
-    if(f.body.hide)
+    unsigned size = tmp.instructions.size();
+    if(inline_budget != 0 && expanded + size > inline_budget)
     {
-      const locationt &new_location = function.find_location();
+      cut_expansions++;
 
-      Forall_goto_program_instructions(it, tmp)
+      if(full)
       {
-        if(new_location.is_not_nil())
-        {
-          // can't just copy, e.g., due to comments field
-          it->location.id(""); // not NIL
-          it->location.set_file(new_location.get_file());
-          it->location.set_line(new_location.get_line());
-          it->location.set_column(new_location.get_column());
-          it->location.set_function(new_location.get_function());
-        }
+        err_location(function);
+        str << "inlining `" << identifier << "' exceeds the budget of "
+            << inline_budget << " instructions";
+        throw 0;
       }
+
+      target++;
+      return;
     }
 
-    // do this recursively
-    goto_inline_rec(tmp, full);
+    // Nested expansions are already part of the body spliced at the top
+    if(recursion_set.empty())
+      expanded += size;
+
+    inlined_funcs.insert(funcs.begin(), funcs.end());
 
     // set up location instruction for function call
     target->type = LOCATION;
@@ -292,8 +395,6 @@ void goto_inlinet::expand_function_call(
 
     dest.instructions.splice(next_target, tmp.instructions);
     target = next_target;
-
-    recursion_set.erase(recursion_it);
   }
   else
   {
@@ -487,7 +588,10 @@ void goto_inline(
     if(it == goto_functions.function_map.end())
       return;
 
+    unsigned old_size = it->second.body.instructions.size();
     goto_inline.goto_inline(it->second.body);
+    goto_inline.report_expansion(it->first, old_size);
+    goto_inline.report_cache();
   }
 
   catch(int)
@@ -533,10 +637,22 @@ void goto_partial_inline(
     for(auto &it : goto_functions.function_map)
     {
       goto_inline.inlined_funcs.clear();
+      goto_inline.expanded = 0;
       if(it.second.body_available)
+      {
+        unsigned old_size = it.second.body.instructions.size();
         goto_inline.goto_inline_rec(it.second.body, false);
+        if(goto_inline.expanded != 0)
+        {
+          // Bodies already inlined elsewhere are now out of date
+          goto_inline.forget(it.first);
+          goto_inline.report_expansion(it.first, old_size);
+        }
+      }
       it.second.inlined_funcs = goto_inline.inlined_funcs;
     }
+
+    goto_inline.report_cache();
   }
 
   catch(int)
@@ -9,9 +9,12 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_GOTO_INLINE_H
 #define CPROVER_GOTO_INLINE_H
 
+#include <cstdlib>
 #include <goto-programs/goto_functions.h>
+#include <unordered_map>
 #include <unordered_set>
 #include <util/message_stream.h>
+#include <util/options.h>
 #include <util/std_types.h>
 
 // do a full inlining
@@ -47,10 +50,16 @@ public:
     message_handlert &_message_handler)
     : message_streamt(_message_handler),
       smallfunc_limit(0),
+      expanded(0),
+      cache_hits(0),
+      cache_misses(0),
       goto_functions(_goto_functions),
       options(_options),
-      ns(_ns)
+      ns(_ns),
+      cut_expansions(0)
   {
+    const std::string &budget = options.get_option("inline-budget");
+    inline_budget = budget.empty() ? 0 : atoi(budget.c_str());
   }
 
   void goto_inline(goto_programt &dest);
@@ -64,8 +73,27 @@ public:
     bool full,
     goto_programt::targett &target);
 
+  // Drop the cached bodies that have the body of function inlined in them.
+  // Must be called whenever that body changes.
+  void forget(const irep_idt &function);
+
+  // Print how much function grew by inlining, from old_size instructions
+  void report_expansion(const irep_idt &function, unsigned old_size);
+
+  // Print how often inlined bodies were reused
+  void report_cache();
+
   unsigned smallfunc_limit;
 
+  // Most instructions inlining may add to a function, 0 for no limit
+  unsigned inline_budget;
+
+  // Instructions added to the function being inlined into so far
+  unsigned expanded;
+
+  unsigned cache_hits;
+  unsigned cache_misses;
+
 protected:
   goto_functionst &goto_functions;
   optionst &options;
@@ -80,6 +108,17 @@ protected:
     const exprt &constrain,
     bool recursive);
 
+  // Fetch the body of a function with every call in it inlined, from the
+  // cache if possible. The names of the functions inlined are stored in
+  // funcs.
+  void get_inlined_body(
+    const irep_idt &identifier,
+    const goto_functiont &f,
+    const exprt &function,
+    bool full,
+    goto_programt &dest,
+    std::set<std::string> &funcs);
+
   void
   replace_return(goto_programt &body, const exprt &lhs, const exprt &constrain);
 
@@ -95,6 +134,23 @@ protected:
   typedef std::unordered_set<irep_idt, irep_id_hash> no_body_sett;
   no_body_sett no_body_set;
 
+  // Bodies with every call inlined, ready to be copied to each call site.
+  // Only complete expansions are kept: a body in which a recursive call or
+  // a call over the budget was left alone depends on where it was inlined.
+  struct cached_bodyt
+  {
+    bool full;
+    goto_programt body;
+    std::set<std::string> inlined_funcs;
+  };
+
+  typedef std::unordered_map<irep_idt, cached_bodyt, irep_id_hash>
+    body_cachet;
+  body_cachet body_cache;
+
+  // Number of calls left alone, because of recursion or of the budget
+  unsigned cut_expansions;
+
 public:
   // Set of function names that have been inlined into the function we're
   // dealing with right now. Fairly hacky, could be improved.
@@ -0,0 +1,477 @@
+/*******************************************************************\
+
+Module: Indexed goto binaries with lazily loaded function bodies
+
+\*******************************************************************/
+
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <goto-programs/goto_program_irep.h>
+#include <goto-programs/indexed_goto_binary.h>
+#include <list>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_set>
+#include <util/irep_serialization.h>
+#include <util/message_stream.h>
+
+// Magic, version number, string table offset and function index offset
+#define HEADER_SIZE (3 + 4 + 8 + 8)
+
+namespace
+{
+void write_varint(std::string &buf, uint64_t value)
+{
+  while(value >= 0x80)
+  {
+    buf.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  buf.push_back(static_cast<char>(value));
+}
+
+void write_fixed(std::string &buf, size_t pos, uint64_t value)
+{
+  for(unsigned int i = 0; i < 8; i++)
+    buf[pos + i] = static_cast<char>(value >> (8 * i));
+}
+
+uint64_t read_fixed(const char *pos)
+{
+  uint64_t value = 0;
+  for(unsigned int i = 0; i < 8; i++)
+    value |= static_cast<uint64_t>(static_cast<uint8_t>(pos[i])) << (8 * i);
+  return value;
+}
+
+// Numbers the strings of the whole file, as they get written
+class string_tablet
+{
+public:
+  unsigned int number(const irep_idt &str)
+  {
+    unsigned int no = str.get_no();
+    if(no >= numbers.size())
+      numbers.resize(no + 1, 0);
+
+    // Numbers are stored off by one, zero means not numbered yet
+    if(numbers[no] == 0)
+    {
+      strings.push_back(str);
+      numbers[no] = strings.size();
+    }
+
+    return numbers[no] - 1;
+  }
+
+  void write(std::string &buf) const
+  {
+    write_varint(buf, strings.size());
+    for(const irep_idt &str : strings)
+    {
+      write_varint(buf, str.size());
+      buf.append(str.c_str(), str.size());
+    }
+  }
+
+protected:
+  std::vector<unsigned int> numbers;
+  std::vector<irep_idt> strings;
+};
+
+// Writes one section of ireps, storing each shared irep once
+class irep_writert
+{
+public:
+  irep_writert(std::string &_buf, string_tablet &_strings)
+    : buf(_buf), strings(_strings)
+  {
+  }
+
+  void write(const irept &irep)
+  {
+    // Ireps sharing their contents are the same node, and the address of
+    // those contents identifies it. Every irep written must stay alive until
+    // the section is done, or that address could be reused.
+    const void *node = &irep.get_sub();
+    auto res = nodes.emplace(node, nodes.size());
+    write_varint(buf, res.first->second);
+    if(!res.second)
+      return;
+
+    write_varint(buf, strings.number(irep.id()));
+
+    write_varint(buf, irep.get_sub().size());
+    for(const irept &sub : irep.get_sub())
+      write(sub);
+
+    write_named(irep.get_named_sub());
+    write_named(irep.get_comments());
+  }
+
+protected:
+  std::string &buf;
+  string_tablet &strings;
+  std::unordered_map<const void *, unsigned int> nodes;
+
+  void write_named(const irept::named_subt &named)
+  {
+    write_varint(buf, named.size());
+    for(const auto &it : named)
+    {
+      write_varint(buf, strings.number(it.first));
+      write(it.second);
+    }
+  }
+};
+
+// Reads back a section written by irep_writert
+class irep_readert
+{
+public:
+  irep_readert(
+    const char *begin,
+    const char *_end,
+    const std::vector<irep_idt> &_strings)
+    : pos(begin), end(_end), strings(_strings)
+  {
+  }
+
+  uint64_t read_varint()
+  {
+    uint64_t value = 0;
+    for(unsigned int shift = 0; shift < 64; shift += 7)
+    {
+      if(pos == end)
+        throw std::string("Truncated goto binary");
+
+      uint8_t byte = *pos++;
+      value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if(!(byte & 0x80))
+        return value;
+    }
+
+    throw std::string("Corrupt goto binary");
+  }
+
+  std::string read_bytes(uint64_t size)
+  {
+    if(size > static_cast<uint64_t>(end - pos))
+      throw std::string("Truncated goto binary");
+
+    std::string bytes(pos, size);
+    pos += size;
+    return bytes;
+  }
+
+  const irep_idt &read_string()
+  {
+    uint64_t no = read_varint();
+    if(no >= strings.size())
+      throw std::string("Corrupt goto binary string reference");
+
+    return strings[no];
+  }
+
+  void read(irept &irep)
+  {
+    uint64_t no = read_varint();
+    if(no < nodes.size())
+    {
+      irep = nodes[no];
+      return;
+    }
+
+    if(no != nodes.size())
+      throw std::string("Corrupt goto binary irep reference");
+    nodes.emplace_back();
+
+    irep.id(read_string());
+
+    uint64_t num_subs = read_varint();
+    irept::subt &subs = irep.get_sub();
+    subs.resize(num_subs);
+    for(irept &sub : subs)
+      read(sub);
+
+    // Comments are told apart from named subs by their name
+    for(unsigned int i = 0; i < 2; i++)
+    {
+      uint64_t num_named = read_varint();
+      for(uint64_t j = 0; j < num_named; j++)
+      {
+        const irep_idt &name = read_string();
+        read(irep.add(name));
+      }
+    }
+
+    nodes[no] = irep;
+  }
+
+protected:
+  const char *pos;
+  const char *end;
+  const std::vector<irep_idt> &strings;
+  std::vector<irept> nodes;
+};
+} // namespace
+
+bool write_indexed_goto_binary(
+  std::ostream &out,
+  const contextt &context,
+  goto_functionst &functions)
+{
+  std::string buf;
+  string_tablet strings;
+
+  buf += "GBF";
+  buf.push_back(0);
+  buf.push_back(0);
+  buf.push_back(0);
+  buf.push_back(INDEXED_GOTO_BINARY_VERSION);
+  buf.resize(HEADER_SIZE);
+
+  {
+    std::list<irept> symbols;
+    context.foreach_operand_in_order([&symbols](const symbolt &s) {
+      symbols.emplace_back();
+      s.to_irep(symbols.back());
+    });
+
+    irep_writert writer(buf, strings);
+    write_varint(buf, symbols.size());
+    for(const irept &irep : symbols)
+      writer.write(irep);
+  }
+
+  std::vector<std::pair<irep_idt, std::pair<uint64_t, uint64_t>>> sections;
+  for(auto &it : functions.function_map)
+  {
+    if(!it.second.body_available)
+      continue;
+
+    it.second.body.compute_location_numbers();
+    irept body;
+    convert(it.second.body, body);
+
+    uint64_t offset = buf.size();
+    irep_writert writer(buf, strings);
+    writer.write(body);
+    sections.emplace_back(
+      it.first, std::make_pair(offset, buf.size() - offset));
+  }
+
+  write_fixed(buf, 15, buf.size());
+  write_varint(buf, sections.size());
+  for(const auto &section : sections)
+  {
+    write_varint(buf, strings.number(section.first));
+    write_varint(buf, section.second.first);
+    write_varint(buf, section.second.second);
+  }
+
+  write_fixed(buf, 7, buf.size());
+  strings.write(buf);
+
+  out.write(buf.data(), buf.size());
+  return !out.good();
+}
+
+bool is_indexed_goto_binary(const std::string &filename)
+{
+  std::ifstream in(filename, std::ios::binary);
+  char hdr[3];
+  if(!in.read(hdr, 3) || hdr[0] != 'G' || hdr[1] != 'B' || hdr[2] != 'F')
+    return false;
+
+  return irep_serializationt::read_long(in) == INDEXED_GOTO_BINARY_VERSION;
+}
+
+indexed_goto_binaryt::indexed_goto_binaryt()
+  : data(nullptr), data_size(0), loaded(0)
+{
+}
+
+indexed_goto_binaryt::~indexed_goto_binaryt()
+{
+  if(data != nullptr)
+    munmap(const_cast<char *>(data), data_size);
+}
+
+bool indexed_goto_binaryt::open(
+  const std::string &filename,
+  contextt &context,
+  goto_functionst &functions,
+  message_handlert &message_handler)
+{
+  message_streamt message_stream(message_handler);
+
+  int fd = ::open(filename.c_str(), O_RDONLY);
+  struct stat st;
+  if(fd == -1 || fstat(fd, &st) != 0)
+  {
+    message_stream.str << "Couldn't open goto binary `" << filename
+                       << "': " << strerror(errno);
+    message_stream.error();
+    if(fd != -1)
+      close(fd);
+    return true;
+  }
+
+  if(st.st_size < HEADER_SIZE)
+  {
+    message_stream.str << "`" << filename << "' is not a goto-binary.";
+    message_stream.error();
+    close(fd);
+    return true;
+  }
+
+  // The mapping outlives the descriptor
+  data_size = st.st_size;
+  void *mem = mmap(nullptr, data_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(mem == MAP_FAILED)
+  {
+    message_stream.str << "Couldn't map goto binary `" << filename
+                       << "': " << strerror(errno);
+    message_stream.error();
+    return true;
+  }
+  data = static_cast<const char *>(mem);
+
+  if(
+    memcmp(data, "GBF", 3) != 0 || data[3] != 0 || data[4] != 0 ||
+    data[5] != 0 || data[6] != INDEXED_GOTO_BINARY_VERSION)
+  {
+    message_stream.str << "`" << filename
+                       << "' is not a version 2 goto-binary.";
+    message_stream.error();
+    return true;
+  }
+
+  uint64_t strings_offset = read_fixed(data + 7);
+  uint64_t index_offset = read_fixed(data + 15);
+  if(strings_offset > data_size || index_offset > strings_offset)
+  {
+    message_stream.str << "Corrupt goto binary `" << filename << "'";
+    message_stream.error();
+    return true;
+  }
+
+  irep_readert string_reader(data + strings_offset, data + data_size, strings);
+  uint64_t num_strings = string_reader.read_varint();
+  strings.reserve(num_strings);
+  for(uint64_t i = 0; i < num_strings; i++)
+    strings.emplace_back(string_reader.read_bytes(string_reader.read_varint()));
+
+  irep_readert symbol_reader(data + HEADER_SIZE, data + index_offset, strings);
+  uint64_t num_symbols = symbol_reader.read_varint();
+  for(uint64_t i = 0; i < num_symbols; i++)
+  {
+    irept t;
+    symbol_reader.read(t);
+    symbolt symbol;
+    symbol.from_irep(t);
+
+    if(!symbol.is_type && symbol.type.is_code())
+    {
+      // makes sure there is an empty function
+      // for every function symbol and fixes
+      // the function types.
+      functions.function_map[symbol.id].type = to_code_type(symbol.type);
+    }
+    context.add(symbol);
+  }
+
+  irep_readert index_reader(
+    data + index_offset, data + strings_offset, strings);
+  uint64_t num_functions = index_reader.read_varint();
+  for(uint64_t i = 0; i < num_functions; i++)
+  {
+    entryt &entry = index[index_reader.read_string()];
+    entry.offset = index_reader.read_varint();
+    entry.size = index_reader.read_varint();
+    entry.loaded = false;
+
+    if(entry.offset < HEADER_SIZE || entry.offset + entry.size > index_offset)
+    {
+      message_stream.str << "Corrupt goto binary `" << filename << "'";
+      message_stream.error();
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void indexed_goto_binaryt::collect_functions(
+  const irept &irep,
+  std::unordered_set<const void *> &seen,
+  std::vector<irep_idt> &dest) const
+{
+  if(!seen.insert(&irep.get_sub()).second)
+    return;
+
+  if(irep.id() == irept::id_symbol)
+  {
+    if(index.count(irep.identifier()) != 0)
+      dest.push_back(irep.identifier());
+    return;
+  }
+
+  for(const irept &sub : irep.get_sub())
+    collect_functions(sub, seen, dest);
+
+  // Comments never refer to functions
+  for(const auto &it : irep.get_named_sub())
+    collect_functions(it.second, seen, dest);
+}
+
+void indexed_goto_binaryt::load_function(
+  const irep_idt &name,
+  goto_functionst &functions,
+  std::vector<irep_idt> &referenced)
+{
+  auto it = index.find(name);
+  if(it == index.end() || it->second.loaded)
+    return;
+
+  entryt &entry = it->second;
+  entry.loaded = true;
+  loaded++;
+
+  const char *begin = data + entry.offset;
+  irep_readert reader(begin, begin + entry.size, strings);
+  irept body;
+  reader.read(body);
+
+  std::unordered_set<const void *> seen;
+  collect_functions(body, seen, referenced);
+
+  goto_functiont &f = functions.function_map[name];
+  convert(body, f.body);
+  f.body_available = f.body.instructions.size() > 0;
+}
+
+void indexed_goto_binaryt::load_reachable(
+  const irep_idt &entry,
+  goto_functionst &functions)
+{
+  std::vector<irep_idt> worklist;
+  if(index.count(entry) != 0)
+    worklist.push_back(entry);
+  else
+  {
+    for(const auto &it : index)
+      worklist.push_back(it.first);
+  }
+
+  while(!worklist.empty())
+  {
+    irep_idt name = worklist.back();
+    worklist.pop_back();
+    load_function(name, functions, worklist);
+  }
+}
@@ -0,0 +1,107 @@
+/*******************************************************************\
+
+Module: Indexed goto binaries with lazily loaded function bodies
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_PROGRAMS_INDEXED_GOTO_BINARY_H
+#define CPROVER_GOTO_PROGRAMS_INDEXED_GOTO_BINARY_H
+
+#include <cstdint>
+#include <goto-programs/goto_functions.h>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <util/context.h>
+#include <util/message.h>
+#include <vector>
+
+#define INDEXED_GOTO_BINARY_VERSION 2
+
+/** @file indexed_goto_binary.h
+ *  Version 2 of the goto binary format. The file starts with the same "GBF"
+ *  magic and version number as version 1, followed by:
+ *
+ *   - the offsets of the string table and of the function index;
+ *   - the symbol table;
+ *   - one section per function body;
+ *   - the function index, mapping each function to its section;
+ *   - the string table, holding every string used in the file once.
+ *
+ *  Numbers are stored as LEB128 varints. Ireps are numbered in order of
+ *  appearance within their section, and each one is stored once, the first
+ *  time it appears; sharing stops at section boundaries, so that any
+ *  function body can be read without reading the others.
+ */
+
+bool write_indexed_goto_binary(
+  std::ostream &out,
+  const contextt &context,
+  goto_functionst &functions);
+
+/* Whether the file starts as a version 2 goto binary */
+bool is_indexed_goto_binary(const std::string &filename);
+
+class indexed_goto_binaryt
+{
+public:
+  indexed_goto_binaryt();
+  ~indexed_goto_binaryt();
+
+  indexed_goto_binaryt(const indexed_goto_binaryt &) = delete;
+  indexed_goto_binaryt &operator=(const indexed_goto_binaryt &) = delete;
+
+  /* Map the file, read its symbols into context and create an empty
+   * function, with the right type, for each function symbol. No body is read
+   * until it's asked for. Returns true on error. */
+  bool open(
+    const std::string &filename,
+    contextt &context,
+    goto_functionst &functions,
+    message_handlert &message_handler);
+
+  /* Read the body of a function into functions, if the file has one and it
+   * hasn't been read yet. Functions referred to by the body, either called
+   * or having their address taken, are appended to referenced. */
+  void load_function(
+    const irep_idt &name,
+    goto_functionst &functions,
+    std::vector<irep_idt> &referenced);
+
+  /* Read the body of the entry point, and of every function it can reach.
+   * Without an entry point every body is read. */
+  void load_reachable(const irep_idt &entry, goto_functionst &functions);
+
+  unsigned int num_loaded() const
+  {
+    return loaded;
+  }
+
+  size_t num_functions() const
+  {
+    return index.size();
+  }
+
+protected:
+  struct entryt
+  {
+    uint64_t offset;
+    uint64_t size;
+    bool loaded;
+  };
+
+  const char *data;
+  size_t data_size;
+  unsigned int loaded;
+
+  std::vector<irep_idt> strings;
+  std::unordered_map<irep_idt, entryt, irep_id_hash> index;
+
+  void collect_functions(
+    const irept &irep,
+    std::unordered_set<const void *> &seen,
+    std::vector<irep_idt> &dest) const;
+};
+
+#endif
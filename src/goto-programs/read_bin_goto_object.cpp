@@ -20,61 +20,89 @@ Date: June 2006
 
 #define BINARY_VERSION 1
 
-bool read_bin_goto_object(
+static bool read_bin_goto_header(
   std::istream &in,
   const std::string &filename,
-  contextt &context,
-  goto_functionst &functions,
-  message_handlert &message_handler)
+  message_streamt &message_stream)
 {
-  message_streamt message_stream(message_handler);
+  char hdr[4];
+  hdr[0] = in.get();
+  hdr[1] = in.get();
+  hdr[2] = in.get();
 
+  if(hdr[0] != 'G' || hdr[1] != 'B' || hdr[2] != 'F')
   {
-    char hdr[4];
-    hdr[0] = in.get();
-    hdr[1] = in.get();
-    hdr[2] = in.get();
+    hdr[3] = in.get();
 
-    if(hdr[0] != 'G' || hdr[1] != 'B' || hdr[2] != 'F')
+    if(hdr[0] == 0x7f && hdr[1] == 'E' && hdr[2] == 'L' && hdr[3] == 'F')
     {
-      hdr[3] = in.get();
-
-      if(hdr[0] == 0x7f && hdr[1] == 'E' && hdr[2] == 'L' && hdr[3] == 'F')
-      {
-        if(filename != "")
-          message_stream.str << "Sorry, but I can't read ELF binary `"
-                             << filename << "'";
-        else
-          message_stream.str << "Sorry, but I can't read ELF binaries";
-      }
+      if(filename != "")
+        message_stream.str << "Sorry, but I can't read ELF binary `"
+                           << filename << "'";
       else
-        message_stream.str << "`" << filename << "' is not a goto-binary."
-                           << std::endl;
+        message_stream.str << "Sorry, but I can't read ELF binaries";
+    }
+    else
+      message_stream.str << "`" << filename << "' is not a goto-binary."
+                         << std::endl;
 
-      message_stream.error();
+    message_stream.error();
 
-      return false;
-    }
+    return false;
+  }
+
+  unsigned version = irep_serializationt::read_long(in);
+
+  if(version != BINARY_VERSION)
+  {
+    message_stream.str << "The input was compiled with a different version of "
+                       << "goto-cc, please recompile";
+    message_stream.warning();
+    return false;
   }
 
+  return true;
+}
+
+bool read_bin_goto_symbols(
+  std::istream &in,
+  const std::string &filename,
+  irep_serializationt::ireps_containert &ic,
+  std::vector<irept> &symbols,
+  message_handlert &message_handler)
+{
+  message_streamt message_stream(message_handler);
+
+  if(!read_bin_goto_header(in, filename, message_stream))
+    return true;
+
+  symbol_serializationt symbolconverter(ic);
+
+  unsigned count = irep_serializationt::read_long(in);
+  symbols.resize(count);
+  for(unsigned i = 0; i < count; i++)
+    symbolconverter.convert(in, symbols[i]);
+
+  return false;
+}
+
+bool read_bin_goto_object(
+  std::istream &in,
+  const std::string &filename,
+  contextt &context,
+  goto_functionst &functions,
+  message_handlert &message_handler)
+{
+  message_streamt message_stream(message_handler);
+
+  if(!read_bin_goto_header(in, filename, message_stream))
+    return false;
+
   irep_serializationt::ireps_containert ic;
   irep_serializationt irepconverter(ic);
   symbol_serializationt symbolconverter(ic);
   goto_function_serializationt gfconverter(ic);
 
-  {
-    unsigned version = irepconverter.read_long(in);
-
-    if(version != BINARY_VERSION)
-    {
-      message_stream.str
-        << "The input was compiled with a different version of "
-        << "goto-cc, please recompile";
-      message_stream.warning();
-      return false;
-    }
-  }
-
   unsigned count = irepconverter.read_long(in);
 
   for(unsigned i = 0; i < count; i++)
@@ -13,7 +13,9 @@ Date: May 2007
 
 #include <goto-programs/goto_functions.h>
 #include <util/context.h>
+#include <util/irep_serialization.h>
 #include <util/message.h>
+#include <vector>
 
 bool read_bin_goto_object(
   std::istream &in,
@@ -22,4 +24,15 @@ bool read_bin_goto_object(
   goto_functionst &functions,
   message_handlert &msg_hndlr);
 
+/* Read only the symbol table of a goto binary, leaving each symbol as the
+ * irep it was stored as, in file order. The stream is left at the start of
+ * the function bodies, which can be read with the same irep container.
+ * Returns true on error. */
+bool read_bin_goto_symbols(
+  std::istream &in,
+  const std::string &filename,
+  irep_serializationt::ireps_containert &ic,
+  std::vector<irept> &symbols,
+  message_handlert &msg_hndlr);
+
 #endif /*READ_BIN_GOTO_OBJECT_H_*/
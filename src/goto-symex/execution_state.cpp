@@ -98,8 +98,7 @@ execution_statet::execution_statet(
   thread_last_reads.emplace_back();
   thread_last_writes.emplace_back();
   // One thread with one dependancy relation.
-  dependancy_chain.emplace_back();
-  dependancy_chain.back().push_back(0);
+  dependancy_chain.add_thread();
   mpor_says_no = false;
 
   cswitch_forced = false;
@@ -123,27 +122,25 @@ execution_statet::execution_statet(const execution_statet &ex)
     global_value_set(ex.global_value_set),
     message_handler(ex.message_handler)
 {
-  *this = ex;
+  copy_members(ex);
 
-  // Regenerate threads state using new objects state_level2 ref
-  threads_state.clear();
-  std::vector<goto_symex_statet>::const_iterator it;
-  for(it = ex.threads_state.begin(); it != ex.threads_state.end(); it++)
-  {
-    goto_symex_statet state(*it, *state_level2, global_value_set);
-    threads_state.push_back(state);
-  }
+  // Regenerate threads state using new objects state_level2 ref. Their call
+  // stacks are shared with ex until either state writes to a frame.
+  threads_state.reserve(ex.threads_state.size());
+  for(const auto &state : ex.threads_state)
+    threads_state.emplace_back(state, *state_level2, global_value_set);
 
   // Reassign which state is currently being worked on.
   cur_state = &threads_state[active_thread];
 }
 
-execution_statet &execution_statet::operator=(const execution_statet &ex)
+void execution_statet::copy_members(const execution_statet &ex)
 {
   // Don't copy level2, copy cons it in execution_statet(ref)
   //state_level2 = ex.state_level2;
+  // Nor threads_state, whose elements refer to level2: the copy constructor
+  // builds it once level2 is set up.
 
-  threads_state = ex.threads_state;
   preserved_paths = ex.preserved_paths;
   atomic_numbers = ex.atomic_numbers;
   DFS_traversed = ex.DFS_traversed;
@@ -179,33 +176,12 @@ execution_statet &execution_statet::operator=(const execution_statet &ex)
   mpor_says_no = ex.mpor_says_no;
   cswitch_forced = ex.cswitch_forced;
 
-  // Vastly irritatingly, we have to iterate through existing level2t objects
-  // updating their ex_state references. There isn't an elegant way of updating
-  // them, it seems, while keeping the symex stuff ignorant of ex_state.
-  // Oooooo, so this is where auto types would be useful...
-  for(auto &it : threads_state)
-  {
-    for(goto_symex_statet::call_stackt::iterator it2 = it.call_stack.begin();
-        it2 != it.call_stack.end();
-        it2++)
-    {
-      for(auto &it3 : it2->goto_state_map)
-      {
-        for(goto_symex_statet::goto_state_listt::iterator it4 =
-              it3.second.begin();
-            it4 != it3.second.begin();
-            it4++)
-        {
-          ex_state_level2t &l2 = dynamic_cast<ex_state_level2t &>(it4->level2);
-          l2.owner = this;
-        }
-      }
-    }
-  }
+  // The level2t objects in the goto_statets waiting to be merged still point
+  // at the state they were created in. They're in frames that are shared with
+  // that state (see goto_symex_statet::call_stackt), so they can't be updated
+  // here without unsharing every frame of every thread.
 
   state_level2->owner = this;
-
-  return *this;
 }
 
 void execution_statet::symex_step(reachability_treet &art)
@@ -302,11 +278,14 @@ void execution_statet::symex_assign(
     analyze_assign(code);
 }
 
-void execution_statet::claim(const expr2tc &expr, const std::string &msg)
+void execution_statet::claim(
+  const expr2tc &expr,
+  const std::string &msg,
+  bool unwinding)
 {
   pre_goto_guard = guardt();
 
-  goto_symext::claim(expr, msg);
+  goto_symext::claim(expr, msg, unwinding);
 
   if(threads_state.size() >= thread_cswitch_threshold)
     analyze_read(expr);
@@ -573,9 +552,12 @@ void execution_statet::cull_all_paths()
 
   // This completely removes all symbolic paths that were going to be merged
   // back in at some point in the future.
-  for(auto &frame : cur_state->call_stack)
+  goto_symex_statet::call_stackt &stack = cur_state->call_stack;
+  for(unsigned int i = 0; i < stack.size(); i++)
   {
-    frame.goto_state_map.clear();
+    // Don't unshare frames that have nothing to clear
+    if(!cur_state->get_call_stack()[i].goto_state_map.empty())
+      stack[i].goto_state_map.clear();
   }
 }
 
@@ -726,17 +708,8 @@ unsigned int execution_statet::add_thread(const goto_programt *prog)
   // Update MPOR tracking data with newly initialized thread
   thread_last_reads.emplace_back();
   thread_last_writes.emplace_back();
-  // Unfortunately as each thread has a depenancy relation with every other
-  // thread we have to do a lot of work to initialize a new one. And initially
-  // all relations are '0', no transitions yet.
-  for(auto &it : dependancy_chain)
-  {
-    it.push_back(0);
-  }
-  // And the new threads dependancies,
-  dependancy_chain.emplace_back();
-  for(unsigned int i = 0; i < dependancy_chain.size(); i++)
-    dependancy_chain.back().push_back(0);
+  // Initially all relations of the new thread are '0', no transitions yet.
+  dependancy_chain.add_thread();
 
   // While we've recorded the new thread as starting in the designated program,
   // it might not run immediately, thus must have it's path preserved:
@@ -756,14 +729,11 @@ void execution_statet::analyze_assign(const expr2tc &code)
   get_expr_globals(ns, assign.target, global_writes);
   get_expr_globals(ns, assign.source, global_reads);
 
-  if(global_reads.size() > 0 || global_writes.size() > 0)
-  {
-    // Record read/written data
-    thread_last_reads[active_thread].insert(
-      global_reads.begin(), global_reads.end());
-    thread_last_writes[active_thread].insert(
-      global_writes.begin(), global_writes.end());
-  }
+  // Record read/written data
+  for(const auto &e : global_reads)
+    thread_last_reads[active_thread].insert(get_mpor_var_id(e));
+  for(const auto &e : global_writes)
+    thread_last_writes[active_thread].insert(get_mpor_var_id(e));
 }
 
 void execution_statet::analyze_read(const expr2tc &code)
@@ -771,12 +741,15 @@ void execution_statet::analyze_read(const expr2tc &code)
   std::set<expr2tc> global_reads, global_writes;
   get_expr_globals(ns, code, global_reads);
 
-  if(global_reads.size() > 0)
-  {
-    // Record read/written data
-    thread_last_reads[active_thread].insert(
-      global_reads.begin(), global_reads.end());
-  }
+  // Record read data
+  for(const auto &e : global_reads)
+    thread_last_reads[active_thread].insert(get_mpor_var_id(e));
+}
+
+unsigned int execution_statet::get_mpor_var_id(const expr2tc &sym)
+{
+  auto &ids = art1->mpor_var_ids;
+  return ids.emplace(sym, ids.size()).first->second;
 }
 
 void execution_statet::get_expr_globals(
@@ -887,25 +860,16 @@ bool execution_statet::check_mpor_dependancy(unsigned int j, unsigned int l)
   // don't intersect with this transitions write(s).
 
   // Double write intersection
-  for(std::set<expr2tc>::const_iterator it = thread_last_writes[j].begin();
-      it != thread_last_writes[j].end();
-      it++)
-    if(thread_last_writes[l].find(*it) != thread_last_writes[l].end())
-      return true;
+  if(thread_last_writes[j].intersects(thread_last_writes[l]))
+    return true;
 
   // This read what that wrote intersection
-  for(std::set<expr2tc>::const_iterator it = thread_last_reads[j].begin();
-      it != thread_last_reads[j].end();
-      it++)
-    if(thread_last_writes[l].find(*it) != thread_last_writes[l].end())
-      return true;
+  if(thread_last_reads[j].intersects(thread_last_writes[l]))
+    return true;
 
   // We wrote what that reads intersection
-  for(std::set<expr2tc>::const_iterator it = thread_last_writes[j].begin();
-      it != thread_last_writes[j].end();
-      it++)
-    if(thread_last_reads[l].find(*it) != thread_last_reads[l].end())
-      return true;
+  if(thread_last_writes[j].intersects(thread_last_reads[l]))
+    return true;
 
   // No check for read-read intersection, it doesn't affect anything
   return false;
@@ -926,54 +890,39 @@ void execution_statet::calculate_mpor_constraints()
   //  dependancy_chain contains the state from the previous transition taken;
   //  here we update it to reflect the latest transition, and make a decision
   //  about progress later.
-  std::vector<std::vector<int>> new_dep_chain = dependancy_chain;
+  mpor_dependency_chaint new_dep_chain = dependancy_chain;
+  unsigned int num_threads = new_dep_chain.size();
 
   // Start new dependancy chain for this thread. Default to there being no
-  // relation.
-  for(unsigned int i = 0; i < new_dep_chain.size(); i++)
-    new_dep_chain[active_thread][i] = -1;
+  // relation; this thread depends on this thread.
+  new_dep_chain.restart_row(active_thread);
 
-  // This thread depends on this thread.
-  new_dep_chain[active_thread][active_thread] = 1;
+  // Threads whose last transition conflicts with the one just taken. Each
+  // check is a few word-wide ANDs; doing them all up front turns the search
+  // for a dependancy chain below into a single mask test per thread.
+  mpor_bitsett conflicts;
+  for(unsigned int l = 0; l < num_threads; l++)
+    if(check_mpor_dependancy(active_thread, l))
+      conflicts.insert(l);
 
   // Mark un-run threads as continuing to be un-run. Otherwise, look for a
   // dependancy chain from each thread to the run thread.
-  for(unsigned int j = 0; j < new_dep_chain.size(); j++)
+  for(unsigned int j = 0; j < num_threads; j++)
   {
     if(j == active_thread)
       continue;
 
-    if(dependancy_chain[j][active_thread] == 0)
-    {
-      // This thread hasn't been run; continue not having been run.
-      new_dep_chain[j][active_thread] = 0;
-    }
-    else
-    {
-      // This is where the beef is. If there is any other thread (including
-      // the active thread) that we depend on, that depends on the active
-      // thread, then record a dependancy.
-      // A direct dependancy occurs when l = j, as DCjj always = 1, and DEPji
-      // is true.
-      int res = 0;
-
-      for(unsigned int l = 0; l < new_dep_chain.size(); l++)
-      {
-        if(dependancy_chain[j][l] != 1)
-          continue; // No dependancy relation here
-
-        // Now check for variable dependancy.
-        if(!check_mpor_dependancy(active_thread, l))
-          continue;
-
-        res = 1;
-        break;
-      }
+    // This thread hasn't been run; continue not having been run.
+    if(dependancy_chain.get(j, active_thread) == 0)
+      continue;
 
-      // Don't overwrite if no match
-      if(res != 0)
-        new_dep_chain[j][active_thread] = res;
-    }
+    // This is where the beef is. If there is any other thread (including
+    // the active thread) that we depend on, that depends on the active
+    // thread, then record a dependancy.
+    // A direct dependancy occurs when l = j, as DCjj always = 1, and DEPji
+    // is true. Don't overwrite if no match.
+    if(dependancy_chain.depends_on_any(j, conflicts))
+      new_dep_chain.set(j, active_thread, 1);
   }
 
   // For /all other relations/, just propagate the dependancy it already has.
@@ -989,21 +938,14 @@ void execution_statet::calculate_mpor_constraints()
   bool can_run = true;
   for(unsigned int j = active_thread + 1; j < threads_state.size(); j++)
   {
-    if(new_dep_chain[j][active_thread] != -1)
+    if(new_dep_chain.get(j, active_thread) != -1)
       // Either no higher threads have been run, or a dependancy relation in
       // a higher thread justifies our out-of-order execution.
       continue;
 
     // Search for a dependancy chain in a lower thread that links us back to
     // a higher thread, justifying this order.
-    bool dep_exists = false;
-    for(unsigned int l = 0; l < active_thread; l++)
-    {
-      if(dependancy_chain[j][l] == 1)
-        dep_exists = true;
-    }
-
-    if(!dep_exists)
+    if(!dependancy_chain.depends_on_any_below(j, active_thread))
     {
       can_run = false;
       break;
@@ -1023,8 +965,8 @@ bool execution_statet::has_cswitch_point_occured() const
     return true;
 
   if(
-    thread_last_reads[active_thread].size() != 0 ||
-    thread_last_writes[active_thread].size() != 0)
+    !thread_last_reads[active_thread].empty() ||
+    !thread_last_writes[active_thread].empty())
     return true;
 
   return false;
@@ -1041,36 +983,32 @@ bool execution_statet::can_execution_continue() const
   return true;
 }
 
-crypto_hash execution_statet::generate_hash() const
+state_fingerprintt execution_statet::generate_hash() const
 {
   auto l2 = std::dynamic_pointer_cast<state_hashing_level2t>(state_level2);
   assert(l2 != nullptr);
 
-  crypto_hash state = l2->generate_l2_state_hash();
-  std::string str = state.to_string();
-
+  state_fingerprintt h = l2->generate_l2_state_hash();
   for(const auto &it : threads_state)
-  {
-    goto_programt::const_targett pc = it.source.pc;
-    int id = pc->location_number;
-    std::stringstream s;
-    s << id;
-    str += "!" + s.str();
-  }
-
-  crypto_hash h;
-  h.ingest(str.c_str(), str.size());
-  h.fin();
+    h.mix(it.source.pc->location_number);
 
   return h;
 }
 
-crypto_hash execution_statet::update_hash_for_assignment(const expr2tc &rhs)
+state_fingerprintt execution_statet::update_hash_for_assignment(
+  const irep_idt &name,
+  const expr2tc &rhs)
 {
+  const std::string &str = name.as_string();
   crypto_hash h;
+  h.ingest(str.c_str(), str.size());
   rhs->hash(h);
   h.fin();
-  return h;
+
+  state_fingerprintt f;
+  f.lo = (uint64_t)h.hash[0] << 32 | h.hash[1];
+  f.hi = (uint64_t)h.hash[2] << 32 | h.hash[3];
+  return f;
 }
 
 void execution_statet::print_stack_traces(unsigned int indent) const
@@ -1229,14 +1167,15 @@ std::shared_ptr<execution_statet> schedule_execution_statet::clone() const
 
 void schedule_execution_statet::claim(
   const expr2tc &expr,
-  const std::string &msg)
+  const std::string &msg,
+  bool unwinding)
 {
   unsigned int tmp_total, tmp_remaining;
 
   tmp_total = total_claims;
   tmp_remaining = remaining_claims;
 
-  execution_statet::claim(expr, msg);
+  execution_statet::claim(expr, msg, unwinding);
 
   tmp_total = total_claims - tmp_total;
   tmp_remaining = remaining_claims - tmp_remaining;
@@ -1263,40 +1202,20 @@ void execution_statet::state_hashing_level2t::make_assignment(
   const expr2tc &const_value,
   const expr2tc &assigned_value)
 {
-  //  crypto_hash hash;
-
   renaming::level2t::make_assignment(lhs_sym, const_value, assigned_value);
 
   // If there's no body to the assignment, don't hash.
   if(!is_nil_expr(assigned_value))
   {
     // XXX - consider whether to use l1 names instead. Recursion, reentrancy.
-    crypto_hash hash = owner->update_hash_for_assignment(assigned_value);
-    std::string orig_name = to_symbol2t(lhs_sym).thename.as_string();
-    current_hashes[orig_name] = hash;
+    const irep_idt &orig_name = to_symbol2t(lhs_sym).thename;
+    state_fingerprintt hash =
+      owner->update_hash_for_assignment(orig_name, assigned_value);
+
+    // Swap the variable's old fingerprint for the new one in the sum
+    state_fingerprintt &entry = current_hashes[orig_name];
+    state_hash -= entry;
+    state_hash += hash;
+    entry = hash;
   }
 }
-
-crypto_hash
-execution_statet::state_hashing_level2t::generate_l2_state_hash() const
-{
-  unsigned int total;
-
-  uint8_t *data = (uint8_t *)alloca(
-    current_hashes.size() * CRYPTO_HASH_SIZE * sizeof(uint8_t));
-
-  total = 0;
-  for(const auto &current_hashe : current_hashes)
-  {
-    memcpy(
-      &data[total * CRYPTO_HASH_SIZE],
-      current_hashe.second.hash,
-      CRYPTO_HASH_SIZE);
-    total++;
-  }
-
-  crypto_hash c;
-  c.ingest(data, total * CRYPTO_HASH_SIZE);
-  c.fin();
-  return c;
-}
@@ -14,7 +14,9 @@
 #include <deque>
 #include <goto-symex/goto_symex.h>
 #include <goto-symex/goto_symex_state.h>
+#include <goto-symex/mpor_bitsets.h>
 #include <goto-symex/renaming.h>
+#include <goto-symex/state_hash_store.h>
 #include <goto-symex/symex_target.h>
 #include <iostream>
 #include <list>
@@ -89,7 +91,7 @@ public:
    *  Does what you might expect, but also updates any ex_state_level2t objects
    *  in the new execution_statet to point at the right object. */
   execution_statet(const execution_statet &ex);
-  execution_statet &operator=(const execution_statet &ex);
+  execution_statet &operator=(const execution_statet &ex) = delete;
 
   /**
    *  Default destructor.
@@ -132,9 +134,17 @@ public:
       expr2tc &lhs_symbol,
       const expr2tc &const_value,
       const expr2tc &assigned_value) override;
-    crypto_hash generate_l2_state_hash() const;
-    typedef std::map<irep_idt, crypto_hash> current_state_hashest;
+    const state_fingerprintt &generate_l2_state_hash() const
+    {
+      return state_hash;
+    }
+
+    typedef std::unordered_map<irep_idt, state_fingerprintt, irep_id_hash>
+      current_state_hashest;
     current_state_hashest current_hashes;
+
+    /** Sum of the fingerprints in current_hashes */
+    state_fingerprintt state_hash;
   };
 
   // Macros
@@ -247,8 +257,12 @@ public:
    *  in this claim.
    *  @param expr Expression that we're asserting is true.
    *  @param msg Textual message explaining this assertion.
+   *  @param unwinding Whether this asserts a loop or recursion bound.
    */
-  void claim(const expr2tc &expr, const std::string &msg) override;
+  void claim(
+    const expr2tc &expr,
+    const std::string &msg,
+    bool unwinding = false) override;
 
   /**
    *  Perform a jump across GOTO code.
@@ -433,6 +447,14 @@ public:
    */
   bool check_mpor_dependancy(unsigned int j, unsigned int l) const;
 
+  /**
+   *  Number a symbol for the MPOR read and write sets. Numbers are shared by
+   *  every execution_statet of the reachability tree.
+   *  @param sym Symbol to number
+   *  @return Small integer identifying the symbol
+   */
+  unsigned int get_mpor_var_id(const expr2tc &sym);
+
   /**
    *  Calculate MPOR schedulable threads. I.E. what threads we can schedule
    *  right now without violating the "quasi-monotonic" property.
@@ -470,20 +492,22 @@ public:
 
   /**
    *  Generate hash of entire execution state.
-   *  This takes all current symbolic assignments to variables contained in the
-   *  l2 renaming object, and their precomputed hashes, concatonates them with
-   *  the current program counter of each thread, and hashes that. This results
-   *  in a full hash of the current execution state.
+   *  This takes the fingerprint of all current symbolic assignments to
+   *  variables, maintained by the l2 renaming object, and mixes the current
+   *  program counter of each thread into it. This results in a full hash of
+   *  the current execution state.
    *  @return Hash of entire current execution state.
    */
-  crypto_hash generate_hash() const;
+  state_fingerprintt generate_hash() const;
 
   /**
-   *  Generate hash of an expression.
+   *  Generate hash of an assignment.
+   *  @param name Name of the variable assigned to.
    *  @param rhs Expression to hash.
-   *  @return Hash of passed in expression.
+   *  @return Fingerprint of the variable having that value.
    */
-  crypto_hash update_hash_for_assignment(const expr2tc &rhs);
+  state_fingerprintt
+  update_hash_for_assignment(const irep_idt &name, const expr2tc &rhs);
 
   /**
    *  Print stack trace of each thread to stdout.
@@ -596,15 +620,17 @@ protected:
   int CS_number;
   /** For each thread, a set of symbols that were read by the thread in the
    *  last transition (run). Renamed to level1, as that identifies each piece of
-   *  data that could have storage in C. */
-  std::vector<std::set<expr2tc>> thread_last_reads;
+   *  data that could have storage in C. Symbols are numbered by
+   *  get_mpor_var_id. */
+  std::vector<mpor_bitsett> thread_last_reads;
   /** For each thread, a set of symbols that were written by the thread in the
    *  last transition (run). Renamed to level1, as that identifies each piece of
-   *  data that could have storage in C. */
-  std::vector<std::set<expr2tc>> thread_last_writes;
+   *  data that could have storage in C. Symbols are numbered by
+   *  get_mpor_var_id. */
+  std::vector<mpor_bitsett> thread_last_writes;
   /** Dependancy chain for POR calculations. In mpor paper, DCij elements map
-   *  to dependancy_chain[i][j] here. */
-  std::vector<std::vector<int>> dependancy_chain;
+   *  to dependancy_chain.get(i, j) here. */
+  mpor_dependency_chaint dependancy_chain;
   /** MPOR scheduling outcome. If we've just taken a transition that MPOR
    *  rejects, this becomes true. For various reasons, we can't tell whether or
    *  not MPOR rejects a transition in advance. */
@@ -627,6 +653,13 @@ public:
   static unsigned int node_count;
 
   friend void build_goto_symex_classes();
+
+private:
+  /**
+   *  Copy the scalar and container members of ex into this state.
+   *  Only for use by the copy constructor: level2 and threads_state are left
+   *  alone, as they have to be rebuilt against this object. */
+  void copy_members(const execution_statet &ex);
 };
 
 /**
@@ -706,7 +739,10 @@ public:
   schedule_execution_statet(const schedule_execution_statet &ref) = default;
   std::shared_ptr<execution_statet> clone() const override;
   ~schedule_execution_statet() override;
-  void claim(const expr2tc &expr, const std::string &msg) override;
+  void claim(
+    const expr2tc &expr,
+    const std::string &msg,
+    bool unwinding = false) override;
 
   unsigned int *ptotal_claims;
   unsigned int *premaining_claims;
@@ -229,8 +229,10 @@ protected:
    *  adds the requirement that the current state guard is true as well.
    *  @param expr Expression that must always be true.
    *  @param msg Textual message explaining assertion.
+   *  @param unwinding Whether this asserts a loop or recursion bound.
    */
-  virtual void claim(const expr2tc &expr, const std::string &msg);
+  virtual void
+  claim(const expr2tc &expr, const std::string &msg, bool unwinding = false);
 
   /**
    *  Perform an assumption.
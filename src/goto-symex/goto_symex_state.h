@@ -21,6 +21,7 @@
 #include <stack>
 #include <string>
 #include <unordered_set>
+#include <util/cow_vector.h>
 #include <util/crypto_hash.h>
 #include <util/guard.h>
 #include <util/i2string.h>
@@ -79,7 +80,9 @@ public:
   typedef std::list<goto_statet> goto_state_listt;
   typedef std::map<goto_programt::const_targett, goto_state_listt>
     goto_state_mapt;
-  typedef std::vector<framet> call_stackt;
+  /** Frames are shared between copies of a state until one of them writes
+   *  to a frame, see cow_vectort. */
+  typedef cow_vectort<framet> call_stackt;
   typedef std::unordered_set<
     renaming::level2t::name_record,
     renaming::level2t::name_rec_hash>
@@ -317,16 +320,24 @@ public:
    */
   inline void pop_frame()
   {
-    assert(call_stack.back().goto_state_map.size() == 0);
+    assert(get_call_stack().back().goto_state_map.size() == 0);
     call_stack.pop_back();
   }
 
   /**
    *  Return stack frame of previous function call.
    */
-  inline const framet &previous_frame()
+  inline const framet &previous_frame() const
   {
-    return *(--(--call_stack.end()));
+    return call_stack[call_stack.size() - 2];
+  }
+
+  /**
+   *  Read-only view of the call stack, that doesn't unshare any frame.
+   */
+  inline const call_stackt &get_call_stack() const
+  {
+    return call_stack;
   }
 
   // Methods
@@ -0,0 +1,205 @@
+/*******************************************************************\
+
+Module: Packed bit sets for partial order reduction
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_SYMEX_MPOR_BITSETS_H
+#define CPROVER_GOTO_SYMEX_MPOR_BITSETS_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+/** Set of small integers, such as thread ids or interned variable ids,
+ *  stored as a bit vector. Intersecting two sets is a word-wide AND. */
+class mpor_bitsett
+{
+public:
+  void insert(unsigned int i)
+  {
+    if(i / 64 >= words.size())
+      words.resize(i / 64 + 1, 0);
+    words[i / 64] |= 1ULL << (i % 64);
+  }
+
+  bool contains(unsigned int i) const
+  {
+    return i / 64 < words.size() && (words[i / 64] & (1ULL << (i % 64)));
+  }
+
+  bool intersects(const mpor_bitsett &other) const
+  {
+    size_t n = std::min(words.size(), other.words.size());
+    for(size_t i = 0; i < n; i++)
+      if(words[i] & other.words[i])
+        return true;
+    return false;
+  }
+
+  bool empty() const
+  {
+    for(uint64_t w : words)
+      if(w)
+        return false;
+    return true;
+  }
+
+  // Keeps the words allocated, the next transition is likely to need them
+  void clear()
+  {
+    std::fill(words.begin(), words.end(), 0);
+  }
+
+  const std::vector<uint64_t> &get_words() const
+  {
+    return words;
+  }
+
+protected:
+  std::vector<uint64_t> words;
+};
+
+/** The MPOR dependency chain: a square matrix with a relation between each
+ *  pair of threads, which is one of
+ *    0: the thread hasn't run yet;
+ *   -1: no relation exists;
+ *    1: there is a dependency between these threads.
+ *  It's stored as two bit planes in a single allocation, with one row per
+ *  thread: whether each relation is set (-1 or 1), and whether it's a
+ *  dependency. Copying it at each transition is then a single memcpy. */
+class mpor_dependency_chaint
+{
+public:
+  mpor_dependency_chaint() : num_threads(0), stride(0)
+  {
+  }
+
+  unsigned int size() const
+  {
+    return num_threads;
+  }
+
+  /* Add a thread, that hasn't run, and that no thread has run since */
+  void add_thread()
+  {
+    unsigned int new_stride = (num_threads + 1 + 63) / 64;
+    if(new_stride != stride)
+    {
+      // Lay the rows out again, each one is a word longer
+      std::vector<uint64_t> old;
+      old.swap(bits);
+      bits.resize(2 * new_stride * (num_threads + 1), 0);
+      for(unsigned int j = 0; j < num_threads; j++)
+        for(unsigned int w = 0; w < stride; w++)
+        {
+          bits[2 * new_stride * j + w] = old[2 * stride * j + w];
+          bits[2 * new_stride * j + new_stride + w] =
+            old[2 * stride * j + stride + w];
+        }
+      stride = new_stride;
+    }
+    else
+      bits.resize(2 * stride * (num_threads + 1), 0);
+
+    num_threads++;
+  }
+
+  int get(unsigned int j, unsigned int i) const
+  {
+    assert(j < num_threads && i < num_threads);
+    if(!test(set_row(j), i))
+      return 0;
+    return test(dep_row(j), i) ? 1 : -1;
+  }
+
+  void set(unsigned int j, unsigned int i, int value)
+  {
+    assert(j < num_threads && i < num_threads);
+    assign(set_row(j), i, value != 0);
+    assign(dep_row(j), i, value == 1);
+  }
+
+  /* Relate thread j to every thread, by no relation but to itself */
+  void restart_row(unsigned int j)
+  {
+    uint64_t *set = set_row(j), *dep = dep_row(j);
+    for(unsigned int w = 0; w < stride; w++)
+    {
+      unsigned int lo = w * 64;
+      set[w] = num_threads - lo >= 64 ? ~0ULL
+                                      : (1ULL << (num_threads - lo)) - 1;
+      dep[w] = 0;
+    }
+    assign(dep, j, true);
+  }
+
+  /* Whether thread j depends on any of the threads in mask */
+  bool depends_on_any(unsigned int j, const mpor_bitsett &mask) const
+  {
+    const uint64_t *dep = dep_row(j);
+    const std::vector<uint64_t> &words = mask.get_words();
+    size_t n = std::min<size_t>(stride, words.size());
+    for(size_t w = 0; w < n; w++)
+      if(dep[w] & words[w])
+        return true;
+    return false;
+  }
+
+  /* Whether thread j depends on any thread numbered below limit */
+  bool depends_on_any_below(unsigned int j, unsigned int limit) const
+  {
+    const uint64_t *dep = dep_row(j);
+    for(unsigned int w = 0; w * 64 < limit; w++)
+    {
+      uint64_t mask = limit - w * 64 >= 64 ? ~0ULL
+                                           : (1ULL << (limit - w * 64)) - 1;
+      if(dep[w] & mask)
+        return true;
+    }
+    return false;
+  }
+
+protected:
+  unsigned int num_threads;
+  // Words per bit plane row
+  unsigned int stride;
+  // Row j is 2 * stride words long: first the set plane, then the dep plane
+  std::vector<uint64_t> bits;
+
+  uint64_t *set_row(unsigned int j)
+  {
+    return &bits[2 * stride * j];
+  }
+
+  const uint64_t *set_row(unsigned int j) const
+  {
+    return &bits[2 * stride * j];
+  }
+
+  uint64_t *dep_row(unsigned int j)
+  {
+    return &bits[2 * stride * j + stride];
+  }
+
+  const uint64_t *dep_row(unsigned int j) const
+  {
+    return &bits[2 * stride * j + stride];
+  }
+
+  static bool test(const uint64_t *row, unsigned int i)
+  {
+    return row[i / 64] & (1ULL << (i % 64));
+  }
+
+  static void assign(uint64_t *row, unsigned int i, bool value)
+  {
+    if(value)
+      row[i / 64] |= 1ULL << (i % 64);
+    else
+      row[i / 64] &= ~(1ULL << (i % 64));
+  }
+};
+
+#endif
@@ -0,0 +1,293 @@
+/*******************************************************************\
+
+Module: Persistent cache of solver verdicts
+
+\*******************************************************************/
+
+#include <ac_config.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <goto-symex/query_cache.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <util/config.h>
+
+#define QUERY_CACHE_MAGIC "ESBMCQC"
+#define QUERY_CACHE_VERSION 1
+#define QUERY_CACHE_SETS 8192
+#define QUERY_CACHE_WAYS 8
+
+struct query_cachet::slott
+{
+  unsigned int key[5];
+  uint32_t verdict;
+  uint64_t last_used;
+};
+
+struct query_cachet::headert
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t num_sets;
+  uint64_t clock;
+  slott slots[QUERY_CACHE_SETS * QUERY_CACHE_WAYS];
+};
+
+enum
+{
+  VERDICT_NONE = 0,
+  VERDICT_SAT,
+  VERDICT_UNSAT
+};
+
+namespace
+{
+// Feeds an equation into a crypto_hash, numbering every renamed symbol in
+// order of first appearance rather than by its SSA name.
+class equation_hashert
+{
+public:
+  explicit equation_hashert(crypto_hash &_hash) : hash(_hash)
+  {
+  }
+
+  void ingest_step(const symex_target_equationt::SSA_stept &step)
+  {
+    uint8_t type = step.type;
+    hash.ingest(&type, sizeof(type));
+
+    ingest_guard(step.guard);
+
+    if(step.is_assignment() || step.is_assume() || step.is_assert())
+      ingest_expr(step.cond);
+    else if(step.is_renumber())
+    {
+      ingest_expr(step.lhs);
+      ingest_expr(step.rhs);
+    }
+  }
+
+protected:
+  crypto_hash &hash;
+  std::unordered_map<symbol_keyt, unsigned int, symbol_key_hash> names;
+
+  // Guards are shared by long runs of steps, only normalise each one once
+  std::unordered_map<const expr2t *, crypto_hash> guards;
+
+  void ingest_expr(const expr2tc &expr)
+  {
+    if(is_nil_expr(expr))
+      return;
+
+    expr2tc tmp = expr;
+    normalise(tmp);
+    tmp->hash(hash);
+  }
+
+  void ingest_guard(const expr2tc &guard)
+  {
+    if(is_nil_expr(guard))
+      return;
+
+    auto it = guards.find(guard.get());
+    if(it == guards.end())
+    {
+      crypto_hash digest;
+      expr2tc tmp = guard;
+      normalise(tmp);
+      tmp->hash(digest);
+      digest.fin();
+      it = guards.emplace(guard.get(), digest).first;
+    }
+
+    hash.ingest(it->second.hash, sizeof(it->second.hash));
+  }
+
+  void normalise(expr2tc &expr)
+  {
+    if(is_symbol2t(expr))
+    {
+      const symbol2t &sym = to_symbol2t(expr);
+      if(
+        sym.rlevel == symbol2t::level0 ||
+        sym.rlevel == symbol2t::level1_global)
+        return;
+
+      // Keep the base name, which the solver converters may look at, but
+      // replace every renaming number with the order of appearance.
+      unsigned int num =
+        names.emplace(symbol_keyt(sym), names.size()).first->second;
+      expr = symbol2tc(sym.type, sym.thename, symbol2t::level2, num, 0, 0, 0);
+      return;
+    }
+
+    expr->Foreach_operand([this](expr2tc &e) {
+      if(!is_nil_expr(e))
+        normalise(e);
+    });
+  }
+};
+} // namespace
+
+crypto_hash query_cachet::hash_equation(
+  const symex_target_equationt &eq,
+  const optionst &options)
+{
+  crypto_hash hash;
+
+  // Anything that changes how the equation is encoded is part of the key
+  std::string config_str = ESBMC_VERSION;
+  config_str += options.get_bool_option("int-encoding") ? " ir" : " bv";
+  config_str += config.ansi_c.use_fixed_for_float ? " fixedbv" : " floatbv";
+  config_str += " " + std::to_string(config.ansi_c.endianess);
+  hash.ingest(config_str.c_str(), config_str.size());
+
+  equation_hashert hasher(hash);
+  for(const auto &SSA_step : eq.SSA_steps)
+  {
+    if(SSA_step.ignore)
+      continue;
+
+    hasher.ingest_step(SSA_step);
+  }
+
+  hash.fin();
+  return hash;
+}
+
+query_cachet::query_cachet(const std::string &dir) : fd(-1), table(nullptr)
+{
+  if(mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST)
+  {
+    std::cerr << "Couldn't create query cache directory " << dir << ": "
+              << strerror(errno) << std::endl;
+    return;
+  }
+
+  std::string filename = dir + "/esbmc-query-cache";
+  fd = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+  if(fd == -1)
+  {
+    std::cerr << "Couldn't open query cache " << filename << ": "
+              << strerror(errno) << std::endl;
+    return;
+  }
+
+  flock(fd, LOCK_EX);
+
+  struct stat st;
+  bool fresh = fstat(fd, &st) == 0 && st.st_size == 0;
+  if(fresh && ftruncate(fd, sizeof(headert)) != 0)
+  {
+    std::cerr << "Couldn't resize query cache " << filename << ": "
+              << strerror(errno) << std::endl;
+    flock(fd, LOCK_UN);
+    return;
+  }
+
+  void *mem =
+    mmap(nullptr, sizeof(headert), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if(mem != MAP_FAILED)
+  {
+    table = static_cast<headert *>(mem);
+
+    // A newly created file reads back as zeroes, so an empty table only
+    // needs its header written. Anything else we don't recognise is wiped.
+    if(
+      fresh || memcmp(table->magic, QUERY_CACHE_MAGIC, 8) != 0 ||
+      table->version != QUERY_CACHE_VERSION ||
+      table->num_sets != QUERY_CACHE_SETS)
+    {
+      memset(static_cast<void *>(table), 0, sizeof(headert));
+      memcpy(table->magic, QUERY_CACHE_MAGIC, 8);
+      table->version = QUERY_CACHE_VERSION;
+      table->num_sets = QUERY_CACHE_SETS;
+    }
+  }
+  else
+    std::cerr << "Couldn't map query cache " << filename << ": "
+              << strerror(errno) << std::endl;
+
+  flock(fd, LOCK_UN);
+}
+
+query_cachet::~query_cachet()
+{
+  if(table != nullptr)
+    munmap(table, sizeof(headert));
+  if(fd != -1)
+    close(fd);
+}
+
+query_cachet::slott *query_cachet::get_set(const crypto_hash &key)
+{
+  return &table->slots[(key.hash[0] % QUERY_CACHE_SETS) * QUERY_CACHE_WAYS];
+}
+
+bool query_cachet::lookup(const crypto_hash &key, smt_convt::resultt &res)
+{
+  if(table == nullptr)
+    return false;
+
+  bool found = false;
+  flock(fd, LOCK_EX);
+
+  slott *set = get_set(key);
+  for(unsigned int i = 0; i < QUERY_CACHE_WAYS; i++)
+  {
+    slott &slot = set[i];
+    if(
+      slot.verdict == VERDICT_NONE ||
+      memcmp(slot.key, key.hash, sizeof(slot.key)) != 0)
+      continue;
+
+    slot.last_used = ++table->clock;
+    res = slot.verdict == VERDICT_SAT ? smt_convt::P_SATISFIABLE
+                                      : smt_convt::P_UNSATISFIABLE;
+    found = true;
+    break;
+  }
+
+  flock(fd, LOCK_UN);
+  return found;
+}
+
+void query_cachet::insert(const crypto_hash &key, smt_convt::resultt res)
+{
+  if(table == nullptr)
+    return;
+
+  // Only definitive answers are worth remembering
+  if(res != smt_convt::P_SATISFIABLE && res != smt_convt::P_UNSATISFIABLE)
+    return;
+
+  flock(fd, LOCK_EX);
+
+  // Reuse the slot holding this key if there is one, otherwise evict the
+  // least recently used slot of the set; empty slots have never been used.
+  slott *set = get_set(key);
+  slott *victim = &set[0];
+  for(unsigned int i = 0; i < QUERY_CACHE_WAYS; i++)
+  {
+    slott &slot = set[i];
+    if(memcmp(slot.key, key.hash, sizeof(slot.key)) == 0)
+    {
+      victim = &slot;
+      break;
+    }
+
+    if(slot.last_used < victim->last_used)
+      victim = &slot;
+  }
+
+  memcpy(victim->key, key.hash, sizeof(victim->key));
+  victim->verdict =
+    res == smt_convt::P_SATISFIABLE ? VERDICT_SAT : VERDICT_UNSAT;
+  victim->last_used = ++table->clock;
+
+  flock(fd, LOCK_UN);
+}
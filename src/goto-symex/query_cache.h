@@ -0,0 +1,59 @@
+/*******************************************************************\
+
+Module: Persistent cache of solver verdicts
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_SYMEX_QUERY_CACHE_H
+#define CPROVER_GOTO_SYMEX_QUERY_CACHE_H
+
+#include <cstdint>
+#include <goto-symex/slice.h>
+#include <goto-symex/symex_target_equation.h>
+#include <solvers/smt/smt_conv.h>
+#include <string>
+#include <util/crypto_hash.h>
+#include <util/options.h>
+
+/** On-disk cache of verdicts, keyed by a hash of the sliced equation.
+ *  Equations are hashed after their SSA names have been renumbered in order
+ *  of appearance, so re-running symex on unchanged code produces the same
+ *  key even if unrelated parts of the program changed the numbering.
+ *
+ *  The cache is a fixed-size, memory-mapped file shared by every ESBMC run
+ *  using the same directory. It is organised as a set-associative table:
+ *  each key maps to a set of slots, and inserting into a full set evicts its
+ *  least recently used entry. Accesses are serialised with flock. */
+class query_cachet
+{
+public:
+  query_cachet(const std::string &dir);
+  ~query_cachet();
+
+  query_cachet(const query_cachet &) = delete;
+  query_cachet &operator=(const query_cachet &) = delete;
+
+  /* Whether the cache file could be opened and mapped. If not, lookups
+   * always miss and inserts do nothing. */
+  bool is_open() const
+  {
+    return table != nullptr;
+  }
+
+  static crypto_hash
+  hash_equation(const symex_target_equationt &eq, const optionst &options);
+
+  bool lookup(const crypto_hash &key, smt_convt::resultt &res);
+  void insert(const crypto_hash &key, smt_convt::resultt res);
+
+protected:
+  struct headert;
+  struct slott;
+
+  int fd;
+  headert *table;
+
+  slott *get_set(const crypto_hash &key);
+};
+
+#endif
@@ -35,6 +35,9 @@ reachability_treet::reachability_treet(
     permanent_context(context),
     ns(ns),
     options(opts),
+    hit_hashes(
+      strtoull(options.get_option("state-hashing-bloom").c_str(), nullptr, 10)
+      << 20),
     message_handler(_message_handler)
 {
   // Put a few useful symbols in the symbol table.
@@ -125,14 +128,7 @@ int reachability_treet::get_CS_bound() const
 
 bool reachability_treet::check_for_hash_collision() const
 {
-  const execution_statet &ex_state = get_cur_state();
-
-  crypto_hash hash;
-  hash = ex_state.generate_hash();
-  if(hit_hashes.find(hash) != hit_hashes.end())
-    return true;
-
-  return false;
+  return hit_hashes.contains(get_cur_state().generate_hash());
 }
 
 void reachability_treet::post_hash_collision_cleanup()
@@ -143,11 +139,12 @@ void reachability_treet::post_hash_collision_cleanup()
 
 void reachability_treet::update_hash_collision_set()
 {
-  execution_statet &ex_state = get_cur_state();
+  hit_hashes.insert(get_cur_state().generate_hash());
+}
 
-  crypto_hash hash;
-  hash = ex_state.generate_hash();
-  hit_hashes.insert(hash);
+void reachability_treet::print_state_hashing_stats(std::ostream &out) const
+{
+  hit_hashes.print_stats(out);
 }
 
 void reachability_treet::create_next_state()
@@ -651,8 +648,14 @@ int reachability_treet::get_ileave_direction_from_scheduling() const
 
 bool reachability_treet::check_thread_viable(unsigned int tid, bool quiet) const
 {
-  const execution_statet &ex = get_cur_state();
+  return check_thread_viable(get_cur_state(), tid, quiet);
+}
 
+bool reachability_treet::check_thread_viable(
+  const execution_statet &ex,
+  unsigned int tid,
+  bool quiet) const
+{
   if(ex.DFS_traversed.at(tid) == true)
   {
     if(!quiet)
@@ -745,6 +748,66 @@ bool reachability_treet::setup_next_formula()
   return reset_to_unexplored_state();
 }
 
+bool reachability_treet::find_unexplored_switches(
+  unsigned int &depth,
+  std::vector<unsigned int> &tids) const
+{
+  // The last state hasn't been run yet, none of its switches are known
+  auto end = execution_states.end();
+  if(execution_states.empty() || --end == execution_states.begin())
+    return false;
+
+  depth = 0;
+  for(auto it = execution_states.begin(); it != end; it++, depth++)
+  {
+    std::vector<unsigned int> unexplored;
+    for(unsigned int tid = 0; tid < (*it)->threads_state.size(); tid++)
+      if(check_thread_viable(**it, tid, true))
+        unexplored.push_back(tid);
+
+    if(unexplored.empty())
+      continue;
+
+    tids.assign(unexplored.begin() + unexplored.size() / 2, unexplored.end());
+    return true;
+  }
+
+  return false;
+}
+
+void reachability_treet::give_away_switches(
+  unsigned int depth,
+  const std::vector<unsigned int> &tids)
+{
+  auto it = execution_states.begin();
+  std::advance(it, depth);
+
+  for(unsigned int tid : tids)
+    (*it)->DFS_traversed.at(tid) = true;
+}
+
+bool reachability_treet::keep_only_switches(
+  unsigned int depth,
+  const std::vector<unsigned int> &tids)
+{
+  auto it = execution_states.begin();
+  for(unsigned int i = 0; i < depth; i++, it++)
+    for(auto &&explored : (*it)->DFS_traversed)
+      explored = true;
+
+  std::vector<bool> explored((*it)->DFS_traversed.size(), true);
+  for(unsigned int tid : tids)
+    explored.at(tid) = (*it)->DFS_traversed.at(tid);
+  (*it)->DFS_traversed = explored;
+
+  // Drop the states below the next one, which reset_to_unexplored_state
+  // drops itself before switching to the first of the kept threads
+  cur_state_it = ++it;
+  execution_states.erase(++it, execution_states.end());
+
+  return reset_to_unexplored_state();
+}
+
 std::shared_ptr<goto_symext::symex_resultt>
 reachability_treet::generate_schedule_formula()
 {
@@ -14,6 +14,7 @@ Author: Lucas Cordeiro, lcc08r@ecs.soton.ac.uk
 #include <goto-symex/execution_state.h>
 #include <goto-symex/goto_symex.h>
 #include <goto-symex/renaming.h>
+#include <goto-symex/state_hash_store.h>
 #include <goto-symex/symex_target_equation.h>
 #include <iostream>
 #include <unordered_map>
@@ -147,6 +148,10 @@ public:
    *  @return True if thread is viable; false otherwise.
    */
   bool check_thread_viable(unsigned int tid, bool quiet) const;
+  bool check_thread_viable(
+    const execution_statet &ex,
+    unsigned int tid,
+    bool quiet) const;
 
   /**
    *  Check whether current ex_state is a state hash collision.
@@ -165,6 +170,11 @@ public:
    */
   void update_hash_collision_set();
 
+  /**
+   *  Print how well state hashing did so far.
+   */
+  void print_state_hashing_stats(std::ostream &out) const;
+
   /**
    *  Perform context switch operation triggered elsewhere.
    *  The analyse_* functions make a decision on whether or not to take a
@@ -250,6 +260,37 @@ public:
    */
   bool setup_next_formula();
 
+  /**
+   *  Pick unexplored context switches to hand over to another explorer.
+   *  Looks for the shallowest execution_statet, short of the one about to be
+   *  explored, with context switches left to take, and picks the second half
+   *  of them: subtrees closer to the root are the largest ones to share.
+   *  @param depth Set to the position of that state in the stack
+   *  @param tids Set to the threads whose switches are handed over
+   *  @return False if there's nothing left to share
+   */
+  bool find_unexplored_switches(
+    unsigned int &depth,
+    std::vector<unsigned int> &tids) const;
+
+  /**
+   *  Leave the given context switches to another explorer.
+   *  They're marked as explored, so this tree never takes them.
+   */
+  void give_away_switches(
+    unsigned int depth,
+    const std::vector<unsigned int> &tids);
+
+  /**
+   *  Only explore the given context switches from now on.
+   *  Every other switch of the stack is marked as explored, and the stack is
+   *  reset to the first of the given ones, as setup_next_formula would.
+   *  @return True if there's a state to be explored
+   */
+  bool keep_only_switches(
+    unsigned int depth,
+    const std::vector<unsigned int> &tids);
+
   /**
    *  Class recording a reachability checkpoint.
    *  Currently likely broken; but this originally redorced a particular trace
@@ -367,7 +408,7 @@ protected:
   /** Whether partial-order-reduction is enabled */
   bool por;
   /** Set of state hashes we've discovered */
-  std::set<crypto_hash> hit_hashes;
+  state_hash_storet hit_hashes;
   /** Message handler reference. */
   message_handlert &message_handler;
   /** Flag as to whether we're picking interleaving directions explicitly.
@@ -383,6 +424,8 @@ protected:
   std::unordered_map<expr2tc, std::list<unsigned int>, irep2_hash> vars_map;
   /* associative container that contains global writes in */
   std::unordered_set<expr2tc, irep2_hash> is_global;
+  /* Numbers given to the globals accessed, for MPOR */
+  std::unordered_map<expr2tc, unsigned int, irep2_hash> mpor_var_ids;
 
   friend class execution_statet;
   friend void build_goto_symex_classes();
@@ -8,18 +8,46 @@ Author: Daniel Kroening, kroening@kroening.com
 
 #include <goto-symex/slice.h>
 
-symex_slicet::symex_slicet(bool assume)
-  : ignored(0),
-    slice_assumes(assume),
-    add_to_deps([this](const symbol2t &s) -> bool {
-      return depends.insert(s.get_symbol_name()).second;
-    })
+symbol_keyt::symbol_keyt(const symbol2t &sym)
+  : thename(sym.thename),
+    level(sym.rlevel),
+    level1_num(0),
+    level2_num(0),
+    thread_num(0),
+    node_num(0)
 {
+  switch(sym.rlevel)
+  {
+  case symbol2t::level0:
+  case symbol2t::level1_global:
+    // Both are printed as the bare name
+    level = symbol2t::level0;
+    break;
+  case symbol2t::level1:
+    level1_num = sym.level1_num;
+    thread_num = sym.thread_num;
+    break;
+  case symbol2t::level2:
+    level1_num = sym.level1_num;
+    thread_num = sym.thread_num;
+    node_num = sym.node_num;
+    level2_num = sym.level2_num;
+    break;
+  case symbol2t::level2_global:
+    node_num = sym.node_num;
+    level2_num = sym.level2_num;
+    break;
+  default:
+    assert(0 && "Unrecognized renaming level enum");
+  }
 }
 
-bool symex_slicet::get_symbols(
-  const expr2tc &expr,
-  std::function<bool(const symbol2t &)> fn)
+symex_slicet::symex_slicet(bool assume) : ignored(0), slice_assumes(assume)
+{
+}
+
+template <typename F>
+bool symex_slicet::get_symbols(const expr2tc &expr, F fn)
 {
   bool res = false;
   expr->foreach_operand([this, &fn, &res](const expr2tc &e) {
@@ -35,9 +63,32 @@ bool symex_slicet::get_symbols(
   return fn(tmp) || res;
 }
 
+bool symex_slicet::add_to_deps(const expr2tc &expr)
+{
+  return get_symbols(expr, [this](const symbol2t &s) -> bool {
+    return depends.emplace(s).second;
+  });
+}
+
+bool symex_slicet::add_guard_to_deps(const expr2tc &guard)
+{
+  if(!collected_guards.insert(guard.get()).second)
+    return false;
+
+  return add_to_deps(guard);
+}
+
+bool symex_slicet::check_in_deps(const expr2tc &expr)
+{
+  return get_symbols(expr, [this](const symbol2t &s) -> bool {
+    return depends.find(symbol_keyt(s)) != depends.end();
+  });
+}
+
 void symex_slicet::slice(std::shared_ptr<symex_target_equationt> &eq)
 {
   depends.clear();
+  collected_guards.clear();
 
   for(symex_target_equationt::SSA_stepst::reverse_iterator it =
         eq->SSA_steps.rbegin();
@@ -51,8 +102,8 @@ void symex_slicet::slice(symex_target_equationt::SSA_stept &SSA_step)
   switch(SSA_step.type)
   {
   case goto_trace_stept::ASSERT:
-    get_symbols(SSA_step.guard, add_to_deps);
-    get_symbols(SSA_step.cond, add_to_deps);
+    add_guard_to_deps(SSA_step.guard);
+    add_to_deps(SSA_step.cond);
     break;
 
   case goto_trace_stept::ASSUME:
@@ -60,8 +111,8 @@ void symex_slicet::slice(symex_target_equationt::SSA_stept &SSA_step)
       slice_assume(SSA_step);
     else
     {
-      get_symbols(SSA_step.guard, add_to_deps);
-      get_symbols(SSA_step.cond, add_to_deps);
+      add_guard_to_deps(SSA_step.guard);
+      add_to_deps(SSA_step.cond);
     }
     break;
 
@@ -83,11 +134,7 @@ void symex_slicet::slice(symex_target_equationt::SSA_stept &SSA_step)
 
 void symex_slicet::slice_assume(symex_target_equationt::SSA_stept &SSA_step)
 {
-  auto check_in_deps = [this](const symbol2t &s) -> bool {
-    return depends.find(s.get_symbol_name()) != depends.end();
-  };
-
-  if(!get_symbols(SSA_step.cond, check_in_deps))
+  if(!check_in_deps(SSA_step.cond))
   {
     // we don't really need it
     SSA_step.ignore = true;
@@ -96,8 +143,8 @@ void symex_slicet::slice_assume(symex_target_equationt::SSA_stept &SSA_step)
   else
   {
     // If we need it, add the symbols to dependency
-    get_symbols(SSA_step.guard, add_to_deps);
-    get_symbols(SSA_step.cond, add_to_deps);
+    add_guard_to_deps(SSA_step.guard);
+    add_to_deps(SSA_step.cond);
   }
 }
 
@@ -105,11 +152,7 @@ void symex_slicet::slice_assignment(symex_target_equationt::SSA_stept &SSA_step)
 {
   assert(is_symbol2t(SSA_step.lhs));
 
-  auto check_in_deps = [this](const symbol2t &s) -> bool {
-    return depends.find(s.get_symbol_name()) != depends.end();
-  };
-
-  if(!get_symbols(SSA_step.lhs, check_in_deps))
+  if(!check_in_deps(SSA_step.lhs))
   {
     // we don't really need it
     SSA_step.ignore = true;
@@ -117,12 +160,12 @@ void symex_slicet::slice_assignment(symex_target_equationt::SSA_stept &SSA_step)
   }
   else
   {
-    get_symbols(SSA_step.guard, add_to_deps);
-    get_symbols(SSA_step.rhs, add_to_deps);
+    add_guard_to_deps(SSA_step.guard);
+    add_to_deps(SSA_step.rhs);
 
     // Remove this symbol as we won't be seeing any references to it further
     // into the history.
-    depends.erase(to_symbol2t(SSA_step.lhs).get_symbol_name());
+    depends.erase(symbol_keyt(to_symbol2t(SSA_step.lhs)));
   }
 }
 
@@ -130,11 +173,7 @@ void symex_slicet::slice_renumber(symex_target_equationt::SSA_stept &SSA_step)
 {
   assert(is_symbol2t(SSA_step.lhs));
 
-  auto check_in_deps = [this](const symbol2t &s) -> bool {
-    return depends.find(s.get_symbol_name()) != depends.end();
-  };
-
-  if(!get_symbols(SSA_step.lhs, check_in_deps))
+  if(!check_in_deps(SSA_step.lhs))
   {
     // we don't really need it
     SSA_step.ignore = true;
@@ -16,22 +16,68 @@ Author: Daniel Kroening, kroening@kroening.com
 BigInt slice(std::shared_ptr<symex_target_equationt> &eq, bool slice_assume);
 BigInt simple_slice(std::shared_ptr<symex_target_equationt> &eq);
 
+/** Identifies a renamed symbol without building its name.
+ *  Two symbols have equal keys iff symbol2t::get_symbol_name would produce
+ *  the same string for both of them: fields that aren't part of the name at
+ *  the symbol's renaming level are zeroed out. */
+struct symbol_keyt
+{
+  explicit symbol_keyt(const symbol2t &sym);
+
+  bool operator==(const symbol_keyt &ref) const
+  {
+    return thename == ref.thename && level == ref.level &&
+           level1_num == ref.level1_num && level2_num == ref.level2_num &&
+           thread_num == ref.thread_num && node_num == ref.node_num;
+  }
+
+  irep_idt thename;
+  unsigned int level;
+  unsigned int level1_num;
+  unsigned int level2_num;
+  unsigned int thread_num;
+  unsigned int node_num;
+};
+
+struct symbol_key_hash
+{
+  size_t operator()(const symbol_keyt &key) const
+  {
+    size_t hash = key.thename.hash();
+    hash = hash * 31 + key.level;
+    hash = hash * 31 + key.level1_num;
+    hash = hash * 31 + key.level2_num;
+    hash = hash * 31 + key.thread_num;
+    hash = hash * 31 + key.node_num;
+    return hash;
+  }
+};
+
 class symex_slicet
 {
 public:
   symex_slicet(bool assume);
   void slice(std::shared_ptr<symex_target_equationt> &eq);
 
-  typedef std::unordered_set<std::string> symbol_sett;
+  typedef std::unordered_set<symbol_keyt, symbol_key_hash> symbol_sett;
   symbol_sett depends;
   BigInt ignored;
 
 protected:
   bool slice_assumes;
-  std::function<bool(const symbol2t &)> add_to_deps;
 
-  bool
-  get_symbols(const expr2tc &expr, std::function<bool(const symbol2t &)> fn);
+  // Guards whose symbols have already been added to depends. Guards are
+  // shared between many consecutive steps, and in SSA form none of their
+  // symbols can be defined between two uses, so they only need to be walked
+  // once.
+  std::unordered_set<const expr2t *> collected_guards;
+
+  template <typename F>
+  bool get_symbols(const expr2tc &expr, F fn);
+
+  bool add_to_deps(const expr2tc &expr);
+  bool add_guard_to_deps(const expr2tc &guard);
+  bool check_in_deps(const expr2tc &expr);
 
   void slice(symex_target_equationt::SSA_stept &SSA_step);
   void slice_assume(symex_target_equationt::SSA_stept &SSA_step);
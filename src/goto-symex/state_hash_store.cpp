@@ -0,0 +1,153 @@
+/*******************************************************************\
+
+Module: Store of visited state hashes
+
+\*******************************************************************/
+
+#include <cmath>
+#include <goto-symex/state_hash_store.h>
+
+static inline uint64_t mix64(uint64_t x)
+{
+  // splitmix64 finaliser
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
+
+void state_fingerprintt::mix(uint64_t value)
+{
+  lo = mix64(lo ^ mix64(value));
+  hi = mix64(hi + lo + value);
+}
+
+state_hash_storet::state_hash_storet(uint64_t bloom_bytes)
+  : bitstate(bloom_bytes != 0), num_entries(0), lookups(0), hits(0)
+{
+  if(bitstate)
+    bits.resize((bloom_bytes + 7) / 8, 0);
+  else
+    slots.resize(1024);
+}
+
+state_fingerprintt state_hash_storet::key(const state_fingerprintt &f)
+{
+  // The all-zero fingerprint marks free slots, move it out of the way
+  if(f.lo == 0 && f.hi == 0)
+    return state_fingerprintt(0, 1);
+  return f;
+}
+
+uint64_t state_hash_storet::find_slot(const state_fingerprintt &k) const
+{
+  // Linear probing, the table is a power of two and at most half full
+  uint64_t mask = slots.size() - 1;
+  uint64_t i = k.lo & mask;
+  while(!(slots[i] == k) && !(slots[i].lo == 0 && slots[i].hi == 0))
+    i = (i + 1) & mask;
+  return i;
+}
+
+void state_hash_storet::grow()
+{
+  std::vector<state_fingerprintt> old;
+  old.swap(slots);
+  slots.resize(old.size() * 2);
+
+  for(const auto &f : old)
+    if(f.lo != 0 || f.hi != 0)
+      slots[find_slot(f)] = f;
+}
+
+bool state_hash_storet::test_bits(const state_fingerprintt &f) const
+{
+  // Double hashing: the i-th bit is at lo + i * hi
+  uint64_t num_bits = bits.size() * 64;
+  for(unsigned int i = 0; i < bloom_hashes; i++)
+  {
+    uint64_t bit = (f.lo + i * (f.hi | 1)) % num_bits;
+    if(!(bits[bit / 64] & (1ULL << (bit % 64))))
+      return false;
+  }
+  return true;
+}
+
+void state_hash_storet::set_bits(const state_fingerprintt &f)
+{
+  uint64_t num_bits = bits.size() * 64;
+  for(unsigned int i = 0; i < bloom_hashes; i++)
+  {
+    uint64_t bit = (f.lo + i * (f.hi | 1)) % num_bits;
+    bits[bit / 64] |= 1ULL << (bit % 64);
+  }
+}
+
+bool state_hash_storet::contains(const state_fingerprintt &f) const
+{
+  lookups++;
+
+  bool found;
+  if(bitstate)
+    found = test_bits(f);
+  else
+  {
+    state_fingerprintt k = key(f);
+    found = slots[find_slot(k)] == k;
+  }
+
+  if(found)
+    hits++;
+  return found;
+}
+
+bool state_hash_storet::insert(const state_fingerprintt &f)
+{
+  if(bitstate)
+  {
+    bool found = test_bits(f);
+    if(!found)
+    {
+      set_bits(f);
+      num_entries++;
+    }
+    return found;
+  }
+
+  state_fingerprintt k = key(f);
+  uint64_t i = find_slot(k);
+  if(slots[i] == k)
+    return true;
+
+  slots[i] = k;
+  if(++num_entries * 2 > slots.size())
+    grow();
+  return false;
+}
+
+uint64_t state_hash_storet::memory_usage() const
+{
+  if(bitstate)
+    return bits.size() * sizeof(uint64_t);
+  return slots.size() * sizeof(state_fingerprintt);
+}
+
+void state_hash_storet::print_stats(std::ostream &out) const
+{
+  out << "State hashing: " << num_entries << " states, " << hits << " hits in "
+      << lookups << " lookups";
+  if(lookups != 0)
+    out << " (" << (100 * hits / lookups) << "%)";
+  out << ", " << memory_usage() / 1024 << " KiB";
+
+  if(bitstate)
+  {
+    // Chance that a state never seen looks seen, given how full it is
+    double num_bits = bits.size() * 64.0;
+    double fill = 1 - std::exp(-(bloom_hashes * num_entries / num_bits));
+    out << " bitstate, false positive rate "
+        << std::pow(fill, bloom_hashes) * 100 << "%";
+  }
+}
@@ -0,0 +1,103 @@
+/*******************************************************************\
+
+Module: Store of visited state hashes
+
+\*******************************************************************/
+
+#ifndef CPROVER_GOTO_SYMEX_STATE_HASH_STORE_H
+#define CPROVER_GOTO_SYMEX_STATE_HASH_STORE_H
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/** 128 bit fingerprint of an execution state.
+ *  The fingerprint of the variables is the sum, lane by lane, of one
+ *  fingerprint per variable, covering its name and the hash of the value
+ *  last assigned to it. It's maintained as assignments are made by
+ *  subtracting the variable's old fingerprint and adding the new one, rather
+ *  than by hashing every variable again at each context switch. */
+struct state_fingerprintt
+{
+  uint64_t lo;
+  uint64_t hi;
+
+  state_fingerprintt() : lo(0), hi(0)
+  {
+  }
+
+  state_fingerprintt(uint64_t _lo, uint64_t _hi) : lo(_lo), hi(_hi)
+  {
+  }
+
+  state_fingerprintt &operator+=(const state_fingerprintt &f)
+  {
+    lo += f.lo;
+    hi += f.hi;
+    return *this;
+  }
+
+  state_fingerprintt &operator-=(const state_fingerprintt &f)
+  {
+    lo -= f.lo;
+    hi -= f.hi;
+    return *this;
+  }
+
+  bool operator==(const state_fingerprintt &f) const
+  {
+    return lo == f.lo && hi == f.hi;
+  }
+
+  /* Mix a number into the fingerprint; unlike +=, the order matters */
+  void mix(uint64_t value);
+};
+
+/** Set of the fingerprints of the states visited so far.
+ *
+ *  By default fingerprints are kept in an open-addressing table, 16 bytes
+ *  each, and two states are only considered equal if their fingerprints
+ *  are. In bitstate mode, a fixed-size bloom filter is used instead: it
+ *  takes no more memory however many states are visited, but a false
+ *  positive makes a state that was never visited look visited, and the
+ *  interleavings going through it are then never explored. */
+class state_hash_storet
+{
+public:
+  /* bloom_bytes is the size of the bloom filter, 0 for the exact table */
+  explicit state_hash_storet(uint64_t bloom_bytes = 0);
+
+  bool contains(const state_fingerprintt &f) const;
+
+  /* Returns whether the fingerprint was already in the store */
+  bool insert(const state_fingerprintt &f);
+
+  uint64_t memory_usage() const;
+
+  void print_stats(std::ostream &out) const;
+
+protected:
+  static const unsigned int bloom_hashes = 3;
+
+  bool bitstate;
+
+  // Exact mode: fingerprints, with the all-zero one marking a free slot
+  std::vector<state_fingerprintt> slots;
+  uint64_t num_entries;
+
+  // Bitstate mode
+  std::vector<uint64_t> bits;
+
+  // Statistics
+  mutable uint64_t lookups;
+  mutable uint64_t hits;
+
+  static state_fingerprintt key(const state_fingerprintt &f);
+  uint64_t find_slot(const state_fingerprintt &k) const;
+  void grow();
+
+  bool test_bits(const state_fingerprintt &f) const;
+  void set_bits(const state_fingerprintt &f);
+};
+
+#endif
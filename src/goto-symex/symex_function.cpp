@@ -213,7 +213,7 @@ void goto_symext::symex_function_call_code(const expr2tc &expr)
   {
     if(!no_unwinding_assertions)
     {
-      claim(gen_false_expr(), "recursion unwinding assertion");
+      claim(gen_false_expr(), "recursion unwinding assertion", true);
     }
     else
     {
@@ -25,7 +25,10 @@
 #include <util/std_expr.h>
 #include <vector>
 
-void goto_symext::claim(const expr2tc &claim_expr, const std::string &msg)
+void goto_symext::claim(
+  const expr2tc &claim_expr,
+  const std::string &msg,
+  bool unwinding)
 {
   // Convert asserts in assumes, if it's not the last loop iteration
   // also, don't convert assertions added by the bidirectional search
@@ -63,7 +66,8 @@ void goto_symext::claim(const expr2tc &claim_expr, const std::string &msg)
     msg,
     cur_state->gen_stack_trace(),
     cur_state->source,
-    first_loop);
+    first_loop,
+    unwinding);
 }
 
 void goto_symext::assume(const expr2tc &the_assumption)
@@ -519,7 +523,8 @@ void goto_symext::finish_formula()
       "dereference failure: forgotten memory: " + get_pretty_name(it.name),
       cur_state->gen_stack_trace(),
       cur_state->source,
-      first_loop);
+      first_loop,
+      false);
 
     total_claims++;
     remaining_claims++;
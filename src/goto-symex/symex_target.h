@@ -70,13 +70,16 @@ public:
 
   // record an assertion
   // cond is destroyed
+  // unwinding is set on the assertions symex adds for loop and recursion
+  // bounds
   virtual void assertion(
     const expr2tc &guard,
     const expr2tc &cond,
     const std::string &msg,
     std::vector<stack_framet> stack_trace,
     const sourcet &source,
-    unsigned loop_number) = 0;
+    unsigned loop_number,
+    bool unwinding) = 0;
 
   // Renumber the pointer object of a given symbol
   virtual void renumber(
@@ -6,11 +6,13 @@ Author: Daniel Kroening, kroening@kroening.com
 
 \*******************************************************************/
 
+#include <algorithm>
 #include <cassert>
 #include <goto-symex/goto_symex.h>
 #include <goto-symex/goto_symex_state.h>
 #include <goto-symex/symex_target_equation.h>
 #include <langapi/language_util.h>
+#include <unordered_set>
 #include <util/expr_util.h>
 #include <util/i2string.h>
 #include <util/irep2.h>
@@ -32,15 +34,15 @@ void symex_target_equationt::assignment(
   SSA_steps.emplace_back();
   SSA_stept &SSA_step = SSA_steps.back();
 
-  SSA_step.guard = guard;
-  SSA_step.lhs = lhs;
-  SSA_step.original_lhs = original_lhs;
-  SSA_step.rhs = rhs;
+  SSA_step.guard = share(guard);
+  SSA_step.lhs = share(lhs);
+  SSA_step.original_lhs = share(original_lhs);
+  SSA_step.rhs = share(rhs);
   SSA_step.hidden = hidden;
-  SSA_step.cond = equality2tc(lhs, rhs);
+  SSA_step.cond = share(equality2tc(SSA_step.lhs, SSA_step.rhs));
   SSA_step.type = goto_trace_stept::ASSIGNMENT;
   SSA_step.source = source;
-  SSA_step.stack_trace = stack_trace;
+  SSA_step.stack_trace = intern_stack_trace(std::move(stack_trace));
   SSA_step.loop_number = loop_number;
 
   if(debug_print)
@@ -75,8 +77,8 @@ void symex_target_equationt::assumption(
   SSA_steps.emplace_back();
   SSA_stept &SSA_step = SSA_steps.back();
 
-  SSA_step.guard = guard;
-  SSA_step.cond = cond;
+  SSA_step.guard = share(guard);
+  SSA_step.cond = share(cond);
   SSA_step.type = goto_trace_stept::ASSUME;
   SSA_step.source = source;
   SSA_step.loop_number = loop_number;
@@ -91,17 +93,19 @@ void symex_target_equationt::assertion(
   const std::string &msg,
   std::vector<stack_framet> stack_trace,
   const sourcet &source,
-  unsigned loop_number)
+  unsigned loop_number,
+  bool unwinding)
 {
   SSA_steps.emplace_back();
   SSA_stept &SSA_step = SSA_steps.back();
 
-  SSA_step.guard = guard;
-  SSA_step.cond = cond;
+  SSA_step.guard = share(guard);
+  SSA_step.cond = share(cond);
   SSA_step.type = goto_trace_stept::ASSERT;
+  SSA_step.unwinding = unwinding;
   SSA_step.source = source;
   SSA_step.comment = msg;
-  SSA_step.stack_trace = stack_trace;
+  SSA_step.stack_trace = intern_stack_trace(std::move(stack_trace));
   SSA_step.loop_number = loop_number;
 
   if(debug_print)
@@ -119,9 +123,9 @@ void symex_target_equationt::renumber(
   SSA_steps.emplace_back();
   SSA_stept &SSA_step = SSA_steps.back();
 
-  SSA_step.guard = guard;
-  SSA_step.lhs = symbol;
-  SSA_step.rhs = size;
+  SSA_step.guard = share(guard);
+  SSA_step.lhs = share(symbol);
+  SSA_step.rhs = share(size);
   SSA_step.type = goto_trace_stept::RENUMBER;
   SSA_step.source = source;
 
@@ -142,6 +146,50 @@ void symex_target_equationt::convert(smt_convt &smt_conv)
       smt_conv.make_n_ary(&smt_conv, &smt_convt::mk_or, assertions));
 }
 
+smt_astt symex_target_equationt::convert_merged_steps(smt_convt &smt_conv)
+{
+  smt_astt base_case = smt_conv.convert_ast(
+    symbol2tc(get_bool_type(), "symex::merged_steps::base_case"));
+
+  smt_convt::ast_vec assertions, unwinding_assertions;
+  smt_astt assumpt_ast = smt_conv.convert_ast(gen_true_expr());
+
+  for(auto &SSA_step : SSA_steps)
+  {
+    if(SSA_step.ignore || !SSA_step.is_unwinding_assertion())
+    {
+      convert_internal_step(smt_conv, assumpt_ast, assertions, SSA_step);
+      continue;
+    }
+
+    convert_internal_step(
+      smt_conv, assumpt_ast, unwinding_assertions, SSA_step);
+
+    // In the base case the bound is assumed instead, constraining every
+    // later assertion
+    smt_convt::ast_vec v;
+    v.push_back(assumpt_ast);
+    v.push_back(
+      smt_conv.imply_ast(base_case, smt_conv.convert_ast(SSA_step.cond)));
+    assumpt_ast = smt_conv.make_n_ary(&smt_conv, &smt_convt::mk_and, v);
+  }
+
+  smt_astt false_val = smt_conv.convert_ast(gen_false_expr());
+  smt_astt bc_violation =
+    assertions.empty()
+      ? false_val
+      : smt_conv.make_n_ary(&smt_conv, &smt_convt::mk_or, assertions);
+  smt_astt fc_violation =
+    unwinding_assertions.empty()
+      ? false_val
+      : smt_conv.make_n_ary(&smt_conv, &smt_convt::mk_or, unwinding_assertions);
+
+  smt_conv.assert_ast(smt_conv.mk_or(
+    smt_conv.mk_and(base_case, bc_violation),
+    smt_conv.mk_and(smt_conv.invert_ast(base_case), fc_violation)));
+  return base_case;
+}
+
 void symex_target_equationt::convert_internal_step(
   smt_convt &smt_conv,
   smt_astt &assumpt_ast,
@@ -359,20 +407,88 @@ void symex_target_equationt::check_for_duplicate_assigns() const
 
 unsigned int symex_target_equationt::clear_assertions()
 {
-  unsigned int num_asserts = 0;
+  return SSA_steps.remove_if(
+    [](const SSA_stept &step) { return step.is_assert(); });
+}
 
-  for(SSA_stepst::iterator it = SSA_steps.begin(); it != SSA_steps.end(); it++)
+static size_t hash_stack_trace(const std::vector<stack_framet> &trace)
+{
+  size_t hash = trace.size();
+  for(const auto &frame : trace)
   {
-    if(it->type == goto_trace_stept::ASSERT)
+    size_t loc = frame.src == nullptr ? 0 : frame.src->pc->location_number;
+    hash = (hash * 31) ^ frame.function.hash();
+    hash = (hash * 31) ^ loc;
+  }
+  return hash;
+}
+
+symex_target_equationt::stack_trace_reft
+symex_target_equationt::intern_stack_trace(std::vector<stack_framet> &&trace)
+{
+  if(trace.empty())
+    return stack_trace_reft();
+
+  if(last_stack_trace && *last_stack_trace == trace)
+    return last_stack_trace;
+
+  size_t hash = hash_stack_trace(trace);
+  auto range = stack_trace_pool.equal_range(hash);
+  for(auto it = range.first; it != range.second; ++it)
+  {
+    if(*it->second == trace)
     {
-      SSA_stepst::iterator it2 = it;
-      it--;
-      SSA_steps.erase(it2);
-      num_asserts++;
+      last_stack_trace = it->second;
+      return last_stack_trace;
     }
   }
 
-  return num_asserts;
+  last_stack_trace =
+    std::make_shared<const std::vector<stack_framet>>(std::move(trace));
+  stack_trace_pool.emplace(hash, last_stack_trace);
+  return last_stack_trace;
+}
+
+void symex_target_equationt::print_memstats(std::ostream &out) const
+{
+  size_t num_steps[goto_trace_stept::RENUMBER + 1] = {0};
+  size_t output_args = 0;
+  std::unordered_set<irep_idt, irep_id_hash> comments;
+
+  for(const auto &SSA_step : SSA_steps)
+  {
+    num_steps[SSA_step.type]++;
+    output_args +=
+      SSA_step.output_args.size() + SSA_step.converted_output_args.size();
+    if(!SSA_step.comment.empty())
+      comments.insert(SSA_step.comment);
+  }
+
+  size_t frames = 0;
+  for(const auto &it : stack_trace_pool)
+    frames += it.second->size();
+
+  out << "Equation memory usage:\n";
+  out << "  SSA steps: " << SSA_steps.size() << " ("
+      << num_steps[goto_trace_stept::ASSIGNMENT] << " assignments, "
+      << num_steps[goto_trace_stept::ASSUME]
+      << " assumptions, " << num_steps[goto_trace_stept::ASSERT]
+      << " assertions, " << num_steps[goto_trace_stept::OUTPUT]
+      << " outputs, " << num_steps[goto_trace_stept::RENUMBER]
+      << " renumbers)\n";
+  out << "  Step storage: " << SSA_steps.num_chunks() << " chunks, "
+      << SSA_steps.capacity_bytes() << " bytes (" << sizeof(SSA_stept)
+      << " bytes per step)\n";
+  out << "  Stack traces: " << stack_trace_pool.size() << " interned, "
+      << frames << " frames, " << frames * sizeof(stack_framet) << " bytes\n";
+  out << "  Assertion comments: " << comments.size() << " distinct\n";
+  out << "  Output arguments: " << output_args << " ("
+      << output_args * sizeof(expr2tc) << " bytes)\n";
+  if(use_hash_cons)
+  {
+    out << "  ";
+    hash_cons_stats(out);
+  }
 }
 
 runtime_encoded_equationt::runtime_encoded_equationt(
@@ -545,3 +661,120 @@ tvt runtime_encoded_equationt::ask_solver_question(const expr2tc &question)
 
   return final_res;
 }
+
+incremental_equation_convt::incremental_equation_convt(
+  std::shared_ptr<smt_convt> _conv)
+  : reused_steps(0),
+    converted_steps(0),
+    conv(std::move(_conv)),
+    claims_pushed(false)
+{
+  assert(conv->supports_ctx());
+  assumpt_ast = conv->convert_ast(gen_true_expr());
+}
+
+bool incremental_equation_convt::same_step(
+  const SSA_stept &a,
+  const SSA_stept &b)
+{
+  // Everything convert_internal_step looks at. The expressions are usually
+  // shared between the two equations, which makes comparing them cheap.
+  return a.type == b.type && a.ignore == b.ignore &&
+         a.source.thread_nr == b.source.thread_nr && a.guard == b.guard &&
+         a.cond == b.cond && a.lhs == b.lhs && a.rhs == b.rhs &&
+         a.output_args == b.output_args;
+}
+
+void incremental_equation_convt::convert(
+  std::shared_ptr<symex_target_equationt> eq)
+{
+  if(claims_pushed)
+  {
+    conv->pop_ctx();
+    claims_pushed = false;
+  }
+
+  /* How much of the previous equation is still valid. Asserting a claim
+   * adds nothing to the solver outside of the claims' own context, so the
+   * previous equation's assertions can be skipped when eq doesn't have them.
+   * old_step[i] is the step of the previous equation that step i matches. */
+  symex_target_equationt::SSA_stepst &steps = eq->SSA_steps;
+  std::vector<unsigned int> old_step;
+  unsigned int converted = 0;
+  if(prev)
+  {
+    const symex_target_equationt::SSA_stepst &old_steps = prev->SSA_steps;
+    converted = old_steps.size();
+
+    unsigned int i = 0;
+    while(i < converted && old_step.size() < steps.size())
+    {
+      if(same_step(old_steps[i], steps[old_step.size()]))
+        old_step.push_back(i);
+      else if(!old_steps[i].is_assert())
+        break;
+      i++;
+    }
+
+    // Reuse up to the last matched step, not past skipped assertions
+    unsigned int prefix = old_step.empty() ? 0 : old_step.back() + 1;
+
+    // Contexts can only be popped whole
+    while(converted > prefix)
+    {
+      assert(!levels.empty());
+      const levelt &level = levels.back();
+      converted = level.first_step;
+      assumpt_ast = level.assumpt_ast;
+      levels.pop_back();
+      conv->pop_ctx();
+    }
+  }
+
+  // The kept steps and contexts, numbered as in eq
+  unsigned int kept =
+    std::lower_bound(old_step.begin(), old_step.end(), converted) -
+    old_step.begin();
+  for(auto &level : levels)
+    level.first_step =
+      std::lower_bound(old_step.begin(), old_step.end(), level.first_step) -
+      old_step.begin();
+
+  // The reused steps refer to the solver's view of them in the previous
+  // equation, which counterexamples will be built from. Only the claims eq
+  // still has are checked.
+  assertions.clear();
+  for(unsigned int i = 0; i < kept; i++)
+  {
+    SSA_stept &step = steps[i];
+    const SSA_stept &old_step_i = prev->SSA_steps[old_step[i]];
+    step.guard_ast = old_step_i.guard_ast;
+    step.cond_ast = old_step_i.cond_ast;
+    step.converted_output_args = old_step_i.converted_output_args;
+
+    if(step.is_assert() && !step.ignore)
+      assertions.push_back(conv->invert_ast(step.cond_ast));
+  }
+
+  for(unsigned int i = kept; i < steps.size(); i++)
+  {
+    SSA_stept &step = steps[i];
+    if(i == kept || step.source.thread_nr != steps[i - 1].source.thread_nr)
+    {
+      levels.push_back({i, assumpt_ast});
+      conv->push_ctx();
+    }
+
+    eq->convert_internal_step(*conv, assumpt_ast, assertions, step);
+  }
+
+  reused_steps = kept;
+  converted_steps = steps.size() - kept;
+  prev = std::move(eq);
+
+  conv->push_ctx();
+  claims_pushed = true;
+  if(!assertions.empty())
+    conv->assert_ast(
+      conv->make_n_ary(conv.get(), &smt_convt::mk_or, assertions));
+}
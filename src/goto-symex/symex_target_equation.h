@@ -17,9 +17,13 @@ Author: Daniel Kroening, kroening@kroening.com
 #include <goto-symex/symex_target.h>
 #include <list>
 #include <map>
+#include <memory>
 #include <solvers/smt/smt_conv.h>
+#include <unordered_map>
+#include <util/chunked_vector.h>
 #include <util/config.h>
 #include <util/irep2.h>
+#include <util/irep2_hash_cons.h>
 #include <util/namespace.h>
 #include <vector>
 
@@ -28,11 +32,16 @@ class symex_target_equationt : public symex_targett
 public:
   class SSA_stept;
 
+  // Stack traces are shared between all steps recorded in the same calling
+  // context, see intern_stack_trace.
+  typedef std::shared_ptr<const std::vector<stack_framet>> stack_trace_reft;
+
   symex_target_equationt(const namespacet &_ns) : ns(_ns)
   {
     debug_print = config.options.get_bool_option("symex-ssa-trace");
     ssa_trace = config.options.get_bool_option("ssa-trace");
     ssa_smt_trace = config.options.get_bool_option("ssa-smt-trace");
+    use_hash_cons = config.options.get_bool_option("hash-cons");
   }
 
   // assignment to a variable - must be symbol
@@ -70,7 +79,8 @@ public:
     const std::string &msg,
     std::vector<stack_framet> stack_trace,
     const sourcet &source,
-    unsigned loop_number) override;
+    unsigned loop_number,
+    bool unwinding) override;
 
   void renumber(
     const expr2tc &guard,
@@ -85,6 +95,13 @@ public:
     smt_convt::ast_vec &assertions,
     SSA_stept &s);
 
+  /* Convert the equation so that the base case and the forward condition of
+   * the same bound can both be checked on it. The returned literal selects
+   * the base case: while it holds, unwinding assertions are assumed and every
+   * other assertion is checked; otherwise only the unwinding assertions are.
+   * The equation must have been built with unwinding assertions. */
+  smt_astt convert_merged_steps(smt_convt &smt_conv);
+
   class SSA_stept
   {
   public:
@@ -93,8 +110,14 @@ public:
 
     // One stack trace recorded per function activation record. Valid for
     // assignment and assert steps only. In reverse order (most recent in idx
-    // 0).
-    std::vector<stack_framet> stack_trace;
+    // 0). Interned by the equation, so identical traces share storage.
+    stack_trace_reft stack_trace;
+
+    const std::vector<stack_framet> &get_stack_trace() const
+    {
+      static const std::vector<stack_framet> empty_trace;
+      return stack_trace ? *stack_trace : empty_trace;
+    }
 
     bool is_assert() const
     {
@@ -121,6 +144,12 @@ public:
       return type == goto_trace_stept::SKIP;
     }
 
+    // Generated by symex when a loop or recursion bound has been exceeded
+    bool is_unwinding_assertion() const
+    {
+      return is_assert() && unwinding;
+    }
+
     expr2tc guard;
 
     // for ASSIGNMENT
@@ -128,7 +157,7 @@ public:
 
     // for ASSUME/ASSERT
     expr2tc cond;
-    std::string comment;
+    irep_idt comment;
 
     // for OUTPUT
     std::string format_string;
@@ -147,7 +176,10 @@ public:
     // for bidirectional search
     unsigned loop_number;
 
-    SSA_stept() : ignore(false), hidden(false)
+    // for ASSERT: set by symex on loop and recursion unwinding assertions
+    bool unwinding;
+
+    SSA_stept() : ignore(false), hidden(false), unwinding(false)
     {
     }
 
@@ -168,20 +200,24 @@ public:
     return i;
   }
 
-  typedef std::list<SSA_stept> SSA_stepst;
+  // Steps live in chunks of contiguous memory: appending never moves an
+  // existing step, and steps can be addressed by index in constant time.
+  typedef chunked_vectort<SSA_stept> SSA_stepst;
   SSA_stepst SSA_steps;
 
   SSA_stepst::iterator get_SSA_step(unsigned s)
   {
-    SSA_stepst::iterator it = SSA_steps.begin();
-    for(; s != 0; s--)
-    {
-      assert(it != SSA_steps.end());
-      it++;
-    }
-    return it;
+    assert(s <= SSA_steps.size());
+    return SSA_steps.iterator_at(s);
   }
 
+  // Returns a shared copy of the given stack trace, reusing a previously
+  // recorded one if they are identical.
+  stack_trace_reft intern_stack_trace(std::vector<stack_framet> &&trace);
+
+  // Print a breakdown of the memory used by the equation.
+  void print_memstats(std::ostream &out) const;
+
   void output(std::ostream &out) const;
   void short_output(std::ostream &out, bool show_ignored = false) const;
 
@@ -190,6 +226,8 @@ public:
   void clear()
   {
     SSA_steps.clear();
+    stack_trace_pool.clear();
+    last_stack_trace.reset();
   }
 
   unsigned int clear_assertions();
@@ -206,9 +244,23 @@ public:
 
 protected:
   const namespacet &ns;
+
+  // Pool of interned stack traces, bucketed by hash_stack_trace. The last
+  // interned trace is cached, as consecutive steps usually share it.
+  std::unordered_multimap<size_t, stack_trace_reft> stack_trace_pool;
+  stack_trace_reft last_stack_trace;
+
   bool debug_print;
   bool ssa_trace;
   bool ssa_smt_trace;
+  bool use_hash_cons;
+
+  // Share the recorded expressions with every structurally equal one, if
+  // hash-consing was asked for
+  expr2tc share(const expr2tc &expr) const
+  {
+    return use_hash_cons ? hash_cons(expr) : expr;
+  }
 };
 
 class runtime_encoded_equationt : public symex_target_equationt
@@ -237,12 +289,57 @@ public:
   SSA_stepst::iterator cvt_progress;
 };
 
-extern inline bool operator<(
-  const symex_target_equationt::SSA_stepst::const_iterator a,
-  const symex_target_equationt::SSA_stepst::const_iterator b)
+/* Converts the equations of successive interleavings into the same solver.
+ * Interleavings explored one after another share every step up to the
+ * context switch where they diverge: those steps stay asserted, and only the
+ * ones after it are popped and converted again, so that whatever the solver
+ * learnt about the shared part is kept. A solver context is pushed at every
+ * context switch in the equation, as those are the points where the next
+ * interleaving can diverge. The solver has to support contexts. */
+class incremental_equation_convt
 {
-  return &(*a) < &(*b);
-}
+public:
+  explicit incremental_equation_convt(std::shared_ptr<smt_convt> conv);
+
+  /* Leave the solver holding eq and its claims, as if eq->convert() had been
+   * called on a fresh one. The previous equation's conversion is kept up to
+   * the first step where the two differ. Assertions of the previous equation
+   * that eq doesn't have are skipped over: backtracking removes the ones that
+   * were already checked. */
+  void convert(std::shared_ptr<symex_target_equationt> eq);
+
+  const std::shared_ptr<smt_convt> &get_solver() const
+  {
+    return conv;
+  }
+
+  // Steps of the last equation that were reused and that were converted
+  unsigned int reused_steps;
+  unsigned int converted_steps;
+
+protected:
+  typedef symex_target_equationt::SSA_stept SSA_stept;
+
+  // A solver context, and the conversion state when it was pushed
+  struct levelt
+  {
+    unsigned int first_step;
+    smt_astt assumpt_ast;
+  };
+
+  std::shared_ptr<smt_convt> conv;
+  std::shared_ptr<symex_target_equationt> prev;
+  std::vector<levelt> levels;
+
+  // Conversion state after the last converted step
+  smt_astt assumpt_ast;
+  smt_convt::ast_vec assertions;
+
+  // Whether the claims of prev are asserted, in a context of their own
+  bool claims_pushed;
+
+  static bool same_step(const SSA_stept &a, const SSA_stept &b);
+};
 
 std::ostream &
 operator<<(std::ostream &out, const symex_target_equationt::SSA_stept &step);
@@ -6,10 +6,16 @@ Author: Daniel Kroening, kroening@cs.cmu.edu
 
 \*******************************************************************/
 
+#include <cstdlib>
 #include <fstream>
+#include <goto-programs/indexed_goto_binary.h>
 #include <langapi/language_ui.h>
 #include <langapi/mode.h>
+#include <map>
 #include <memory>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <util/c_link.h>
 #include <util/i2string.h>
 #include <util/show_symbol_table.h>
 
@@ -26,30 +32,66 @@ static ui_message_handlert::uit get_ui_cmdline(const cmdlinet &cmdline)
 }
 
 language_uit::language_uit(const cmdlinet &__cmdline)
-  : ui_message_handler(get_ui_cmdline(__cmdline)), _cmdline(__cmdline)
+  : ui_message_handler(get_ui_cmdline(__cmdline)),
+    _cmdline(__cmdline),
+    parse_in_workers(false)
 {
   set_message_handler(&ui_message_handler);
 }
 
 bool language_uit::parse()
 {
+  unsigned int workers = get_frontend_workers();
   for(const auto &arg : _cmdline.args)
   {
-    if(parse(arg))
+    if(workers > 1)
+    {
+      if(add_file(arg) == nullptr)
+        return true;
+    }
+    else if(parse(arg))
       return true;
   }
 
+  if(workers <= 1)
+    return false;
+
+  // Files are only parsed in the workers if all of them can be type checked
+  // on their own; otherwise parse them here, as usual
+  for(auto &it : language_files.filemap)
+    if(!it.second.language->typechecks_independently())
+      workers = 1;
+
+  if(workers > 1)
+  {
+    parse_in_workers = true;
+    return false;
+  }
+
+  for(auto &it : language_files.filemap)
+    if(parse_file(it.second))
+      return true;
+
   return false;
 }
 
 bool language_uit::parse(const std::string &filename)
+{
+  language_filet *lf = add_file(filename);
+  if(lf == nullptr)
+    return true;
+
+  return parse_file(*lf);
+}
+
+language_filet *language_uit::add_file(const std::string &filename)
 {
   int mode = get_mode_filename(filename);
 
   if(mode < 0)
   {
     error("failed to figure out type of file", filename);
-    return true;
+    return nullptr;
   }
 
   if(config.options.get_bool_option("old-frontend"))
@@ -60,7 +102,7 @@ bool language_uit::parse(const std::string &filename)
   if(!infile)
   {
     error("failed to open input file", filename);
-    return true;
+    return nullptr;
   }
 
   language_filet language_file;
@@ -72,11 +114,17 @@ bool language_uit::parse(const std::string &filename)
   language_filet &lf = result.first->second;
   lf.filename = filename;
   lf.language = mode_table[mode].new_language();
+
+  return &lf;
+}
+
+bool language_uit::parse_file(language_filet &lf)
+{
   languaget &language = *lf.language;
 
-  status("Parsing", filename);
+  status("Parsing", lf.filename);
 
-  if(language.parse(filename, *get_message_handler()))
+  if(language.parse(lf.filename, *get_message_handler()))
   {
     if(get_ui() == ui_message_handlert::PLAIN)
       std::cerr << "PARSING ERROR" << std::endl;
@@ -89,8 +137,129 @@ bool language_uit::parse(const std::string &filename)
   return false;
 }
 
+unsigned int language_uit::get_frontend_workers() const
+{
+  if(
+    _cmdline.args.size() < 2 || !_cmdline.isset("frontend-jobs") ||
+    _cmdline.isset("parse-tree-too") || _cmdline.isset("parse-tree-only"))
+    return 1;
+
+  long jobs = strtol(_cmdline.getval("frontend-jobs"), nullptr, 10);
+  if(jobs == 0)
+    jobs = sysconf(_SC_NPROCESSORS_ONLN);
+
+  return jobs < 1 ? 1 : jobs;
+}
+
+bool language_uit::typecheck_in_workers()
+{
+  std::vector<language_filet *> files;
+  for(auto &it : language_files.filemap)
+    files.push_back(&it.second);
+
+  unsigned int num_workers = get_frontend_workers();
+  status(
+    "Converting " + i2string((unsigned long)files.size()) + " files on " +
+    i2string((unsigned long)num_workers) + " worker processes");
+
+  const char *tmpdir = getenv("TMPDIR");
+  std::string prefix = std::string(tmpdir != nullptr ? tmpdir : "/tmp") +
+                       "/esbmc-tu-" + i2string((unsigned long)getpid()) + "-";
+
+  // Don't let the children flush our buffered output again
+  std::cout.flush();
+  std::cerr.flush();
+
+  /* Each worker parses and converts one file into a context of its own,
+   * which it hands back as a goto binary holding only symbols. The contexts
+   * are then linked here, in the same order as when done in process. */
+  std::vector<bool> converted(files.size(), false);
+  std::map<pid_t, unsigned int> running;
+  unsigned int next_file = 0;
+  while(next_file < files.size() || !running.empty())
+  {
+    while(next_file < files.size() && running.size() < num_workers)
+    {
+      pid_t pid = fork();
+      if(pid == -1)
+      {
+        error("Fork failed");
+        break;
+      }
+
+      if(!pid)
+      {
+        bool failed = true;
+        try
+        {
+          language_filet &lf = *files[next_file];
+          contextt file_context;
+          goto_functionst no_functions;
+          if(
+            !parse_file(lf) &&
+            !lf.language->typecheck(file_context, "", *get_message_handler()))
+          {
+            std::ofstream out(
+              prefix + i2string(next_file), std::ios::out | std::ios::binary);
+            failed = write_indexed_goto_binary(out, file_context, no_functions);
+          }
+        }
+        catch(...)
+        {
+        }
+
+        std::cout.flush();
+        _exit(failed ? 1 : 0);
+      }
+
+      running[pid] = next_file++;
+    }
+
+    // Nothing could be started, and nothing is left to wait for
+    if(running.empty())
+      break;
+
+    int status;
+    pid_t pid = waitpid(-1, &status, 0);
+    auto it = running.find(pid);
+    if(it == running.end())
+      continue;
+
+    converted[it->second] = WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    running.erase(it);
+  }
+
+  bool failed = false;
+  for(unsigned int i = 0; i < files.size(); i++)
+  {
+    std::string filename = prefix + i2string(i);
+    if(!failed && converted[i])
+    {
+      contextt file_context;
+      goto_functionst no_functions;
+      indexed_goto_binaryt binary;
+      failed =
+        binary.open(
+          filename, file_context, no_functions, *get_message_handler()) ||
+        c_link(context, file_context, *get_message_handler(), "");
+    }
+    else
+      failed = true;
+
+    unlink(filename.c_str());
+  }
+
+  if(failed && get_ui() == ui_message_handlert::PLAIN)
+    std::cerr << "CONVERSION ERROR" << std::endl;
+
+  return failed;
+}
+
 bool language_uit::typecheck()
 {
+  if(parse_in_workers)
+    return typecheck_in_workers();
+
   status("Converting");
 
   language_files.set_message_handler(message_handler);
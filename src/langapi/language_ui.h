@@ -49,6 +49,20 @@ public:
 
 protected:
   const cmdlinet &_cmdline;
+
+  // Whether parsing was left to the workers of typecheck_in_workers
+  bool parse_in_workers;
+
+  language_filet *add_file(const std::string &filename);
+  bool parse_file(language_filet &lf);
+
+  /* Number of worker processes the frontend may use, as set by
+   * --frontend-jobs. Running more than one requires several input files. */
+  unsigned int get_frontend_workers() const;
+
+  /* Parse and type check every file in a worker process of its own, then
+   * link the resulting contexts, in file order, into context. */
+  bool typecheck_in_workers();
 };
 
 #endif
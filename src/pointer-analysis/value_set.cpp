@@ -35,7 +35,7 @@ void value_sett::output(std::ostream &out) const
   {
     std::string identifier, display_name;
 
-    const entryt &e = value.second;
+    const entryt &e = *value.second;
 
     if(has_prefix(e.identifier, "value_set::dynamic_object"))
     {
@@ -129,6 +129,29 @@ expr2tc value_sett::to_expr(object_mapt::const_iterator it) const
   return obj;
 }
 
+/* Whether every record of src is already in dest, in which case merging src
+ * into dest would leave it unchanged. */
+static bool contains(
+  const value_sett::object_mapt &dest,
+  const value_sett::object_mapt &src)
+{
+  for(const auto &it : src)
+  {
+    value_sett::object_mapt::const_iterator found = dest.find(it.first);
+    if(found == dest.end())
+      return false;
+
+    const value_sett::objectt &a = found->second, &b = it.second;
+    if(
+      a.offset_is_set != b.offset_is_set ||
+      a.offset_alignment != b.offset_alignment ||
+      (a.offset_is_set && a.offset != b.offset))
+      return false;
+  }
+
+  return true;
+}
+
 bool value_sett::make_union(const value_sett::valuest &new_values, bool keepnew)
 {
   bool result = false;
@@ -147,9 +170,9 @@ bool value_sett::make_union(const value_sett::valuest &new_values, bool keepnew)
       // variables not existing in the state we're merging into is irrelevant.
       if(
         has_prefix(
-          id2string(new_value.second.identifier),
+          id2string(new_value.second->identifier),
           "value_set::dynamic_object") ||
-        new_value.second.identifier == "value_set::return_value" || keepnew)
+        new_value.second->identifier == "value_set::return_value" || keepnew)
       {
         values.insert(new_value);
         result = true;
@@ -158,11 +181,18 @@ bool value_sett::make_union(const value_sett::valuest &new_values, bool keepnew)
       continue;
     }
 
-    // The variable was in this' set, merge the values.
-    entryt &e = it2->second;
-    const entryt &new_e = new_value.second;
+    // Both sets still share this entry, it hasn't changed since they
+    // diverged and there's nothing to merge
+    if(it2->second.shares(new_value.second))
+      continue;
+
+    // The variable was in this' set, merge the values. Only take a private
+    // copy of the entry if new_e holds something it doesn't.
+    const entryt &new_e = *new_value.second;
+    if(contains(it2->second->object_map, new_e.object_map))
+      continue;
 
-    if(make_union(e.object_map, new_e.object_map))
+    if(make_union(it2->second.write().object_map, new_e.object_map))
       result = true;
   }
 
@@ -430,7 +460,7 @@ void value_sett::get_value_set_rec(
 
     if(v_it != values.end())
     {
-      make_union(dest, v_it->second.object_map);
+      make_union(dest, v_it->second->object_map);
       return;
     }
   }
@@ -495,7 +525,7 @@ void value_sett::get_value_set_rec(
     // If it points at things, put those things into the destination object map.
     if(v_it != values.end())
     {
-      make_union(dest, v_it->second.object_map);
+      make_union(dest, v_it->second->object_map);
       return;
     }
   }
@@ -1075,8 +1105,8 @@ void value_sett::do_free(const expr2tc &op)
 
     bool changed = false;
 
-    for(object_mapt::const_iterator o_it = value.second.object_map.begin();
-        o_it != value.second.object_map.end();
+    for(object_mapt::const_iterator o_it = value.second->object_map.begin();
+        o_it != value.second->object_map.end();
         o_it++)
     {
       const expr2tc &object = object_numbering[o_it->first];
@@ -1103,7 +1133,7 @@ void value_sett::do_free(const expr2tc &op)
     }
 
     if(changed)
-      value.second.object_map = new_object_map;
+      value.second.write().object_map = new_object_map;
   }
 }
 
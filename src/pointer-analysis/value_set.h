@@ -252,10 +252,48 @@ public:
     }
   };
 
+  /** Copy-on-write reference to an entryt. Copying a value set, which symex
+   *  does at every branch, only copies these references: an entry is
+   *  duplicated when one of the value sets sharing it writes to it, and
+   *  merging two value sets skips the entries they still share. */
+  class entry_reft
+  {
+  public:
+    explicit entry_reft(const entryt &e) : ptr(std::make_shared<entryt>(e))
+    {
+    }
+
+    const entryt &operator*() const
+    {
+      return *ptr;
+    }
+
+    const entryt *operator->() const
+    {
+      return ptr.get();
+    }
+
+    /** Get a copy of the entry private to this reference. */
+    entryt &write()
+    {
+      if(ptr.use_count() > 1)
+        ptr = std::make_shared<entryt>(*ptr);
+      return *ptr;
+    }
+
+    bool shares(const entry_reft &ref) const
+    {
+      return ptr == ref.ptr;
+    }
+
+  protected:
+    std::shared_ptr<entryt> ptr;
+  };
+
   /** Type of the value-set containing structure. A hash map mapping variables
    *  to an entryt, storing the value set of objects a variable might point
    *  at. */
-  typedef std::unordered_map<irep_idt, entryt, irep_id_hash> valuest;
+  typedef std::unordered_map<irep_idt, entry_reft, irep_id_hash> valuest;
 
   /** Get the natural alignment unit of a reference to e. I don't know a more
    *  appropriate term, but if we were to have an offset into e, then what is
@@ -482,10 +520,11 @@ public:
   {
     std::string index = id2string(e.identifier) + e.suffix;
 
-    std::pair<valuest::iterator, bool> r =
-      values.insert(std::pair<irep_idt, entryt>(index, e));
+    valuest::iterator it = values.find(index);
+    if(it == values.end())
+      it = values.emplace(index, entry_reft(e)).first;
 
-    return r.first->second;
+    return it->second.write();
   }
 
   /** Add a value set for each variable in the given list. */
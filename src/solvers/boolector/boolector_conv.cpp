@@ -811,19 +811,19 @@ void boolector_convt::print_model()
 
 smt_sortt boolector_convt::mk_bool_sort()
 {
-  return new solver_smt_sort<BoolectorSort>(
+  return new(this) solver_smt_sort<BoolectorSort>(
     SMT_SORT_BOOL, boolector_bool_sort(btor), 1);
 }
 
 smt_sortt boolector_convt::mk_bv_sort(std::size_t width)
 {
-  return new solver_smt_sort<BoolectorSort>(
+  return new(this) solver_smt_sort<BoolectorSort>(
     SMT_SORT_BV, boolector_bitvec_sort(btor, width), width);
 }
 
 smt_sortt boolector_convt::mk_fbv_sort(std::size_t width)
 {
-  return new solver_smt_sort<BoolectorSort>(
+  return new(this) solver_smt_sort<BoolectorSort>(
     SMT_SORT_FIXEDBV, boolector_bitvec_sort(btor, width), width);
 }
 
@@ -833,13 +833,13 @@ smt_sortt boolector_convt::mk_array_sort(smt_sortt domain, smt_sortt range)
   auto range_sort = to_solver_smt_sort<BoolectorSort>(range);
 
   auto t = boolector_array_sort(btor, domain_sort->s, range_sort->s);
-  return new solver_smt_sort<BoolectorSort>(
+  return new(this) solver_smt_sort<BoolectorSort>(
     SMT_SORT_ARRAY, t, domain_sort->get_data_width(), range);
 }
 
 smt_sortt boolector_convt::mk_bvfp_sort(std::size_t ew, std::size_t sw)
 {
-  return new solver_smt_sort<BoolectorSort>(
+  return new(this) solver_smt_sort<BoolectorSort>(
     SMT_SORT_BVFP,
     boolector_bitvec_sort(btor, ew + sw + 1),
     ew + sw + 1,
@@ -848,6 +848,6 @@ smt_sortt boolector_convt::mk_bvfp_sort(std::size_t ew, std::size_t sw)
 
 smt_sortt boolector_convt::mk_bvfp_rm_sort()
 {
-  return new solver_smt_sort<BoolectorSort>(
+  return new(this) solver_smt_sort<BoolectorSort>(
     SMT_SORT_BVFP_RM, boolector_bitvec_sort(btor, 3), 3);
 }
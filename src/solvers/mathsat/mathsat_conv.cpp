@@ -1005,7 +1005,8 @@ smt_sortt mathsat_convt::mk_fpbv_sort(const unsigned ew, const unsigned sw)
     return fp_convt::mk_fpbv_sort(ew, sw);
 
   auto t = msat_get_fp_type(env, ew, sw);
-  return new solver_smt_sort<msat_type>(SMT_SORT_FPBV, t, ew + sw + 1, sw + 1);
+  return new(this) solver_smt_sort<msat_type>(
+    SMT_SORT_FPBV, t, ew + sw + 1, sw + 1);
 }
 
 smt_sortt mathsat_convt::mk_fpbv_rm_sort()
@@ -1014,48 +1015,48 @@ smt_sortt mathsat_convt::mk_fpbv_rm_sort()
     return mk_bvfp_rm_sort();
 
   auto t = msat_get_fp_roundingmode_type(env);
-  return new solver_smt_sort<msat_type>(SMT_SORT_FPBV_RM, t, 3);
+  return new(this) solver_smt_sort<msat_type>(SMT_SORT_FPBV_RM, t, 3);
 }
 
 smt_sortt mathsat_convt::mk_bvfp_sort(std::size_t ew, std::size_t sw)
 {
-  return new solver_smt_sort<msat_type>(
+  return new(this) solver_smt_sort<msat_type>(
     SMT_SORT_BVFP, msat_get_bv_type(env, ew + sw + 1), ew + sw + 1, sw + 1);
 }
 
 smt_sortt mathsat_convt::mk_bvfp_rm_sort()
 {
-  return new solver_smt_sort<msat_type>(
+  return new(this) solver_smt_sort<msat_type>(
     SMT_SORT_BVFP_RM, msat_get_bv_type(env, 3), 3);
 }
 
 smt_sortt mathsat_convt::mk_bool_sort()
 {
-  return new solver_smt_sort<msat_type>(
+  return new(this) solver_smt_sort<msat_type>(
     SMT_SORT_BOOL, msat_get_bool_type(env), 1);
 }
 
 smt_sortt mathsat_convt::mk_real_sort()
 {
-  return new solver_smt_sort<msat_type>(
+  return new(this) solver_smt_sort<msat_type>(
     SMT_SORT_REAL, msat_get_rational_type(env), 0);
 }
 
 smt_sortt mathsat_convt::mk_int_sort()
 {
-  return new solver_smt_sort<msat_type>(
+  return new(this) solver_smt_sort<msat_type>(
     SMT_SORT_INT, msat_get_integer_type(env), 0);
 }
 
 smt_sortt mathsat_convt::mk_bv_sort(std::size_t width)
 {
-  return new solver_smt_sort<msat_type>(
+  return new(this) solver_smt_sort<msat_type>(
     SMT_SORT_BV, msat_get_bv_type(env, width), width);
 }
 
 smt_sortt mathsat_convt::mk_fbv_sort(std::size_t width)
 {
-  return new solver_smt_sort<msat_type>(
+  return new(this) solver_smt_sort<msat_type>(
     SMT_SORT_FIXEDBV, msat_get_bv_type(env, width), width);
 }
 
@@ -1065,7 +1066,7 @@ smt_sortt mathsat_convt::mk_array_sort(smt_sortt domain, smt_sortt range)
   auto range_sort = to_solver_smt_sort<msat_type>(range);
 
   auto t = msat_get_array_type(env, domain_sort->s, range_sort->s);
-  return new solver_smt_sort<msat_type>(
+  return new(this) solver_smt_sort<msat_type>(
     SMT_SORT_ARRAY, t, domain->get_data_width(), range);
 }
 
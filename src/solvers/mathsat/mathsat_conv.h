@@ -127,6 +127,10 @@ public:
 
   void push_ctx() override;
   void pop_ctx() override;
+  bool supports_ctx() const override
+  {
+    return true;
+  }
 
   bool get_bool(smt_astt a) override;
   BigInt get_bv(smt_astt a) override;
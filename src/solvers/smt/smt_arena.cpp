@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cassert>
+#include <solvers/smt/smt_arena.h>
+
+smt_arenat::smt_arenat()
+  : blocks_in_use(0),
+    cur(nullptr),
+    avail(0),
+    bytes_in_use(0),
+    peak_bytes_in_use(0),
+    num_allocations(0),
+    num_releases(0)
+{
+}
+
+smt_arenat::~smt_arenat()
+{
+  for(auto &block : blocks)
+    delete[] block.data;
+}
+
+void *smt_arenat::allocate_from_new_block(std::size_t size)
+{
+  // Reuse the next block if it's large enough, otherwise replace it. Objects
+  // larger than a block get a block of their own.
+  if(blocks_in_use == blocks.size())
+    blocks.push_back({nullptr, 0});
+
+  blockt &block = blocks[blocks_in_use];
+  if(block.size < size)
+  {
+    delete[] block.data;
+    block.size = std::max(block_size, size);
+    block.data = new char[block.size];
+  }
+
+  blocks_in_use++;
+  cur = block.data + size;
+  avail = block.size - size;
+  note_allocation(size);
+  return block.data;
+}
+
+smt_arenat::markt smt_arenat::mark() const
+{
+  std::size_t offset = 0;
+  if(blocks_in_use != 0)
+    offset = cur - blocks[blocks_in_use - 1].data;
+  return {blocks_in_use, offset, bytes_in_use};
+}
+
+void smt_arenat::release(const markt &m)
+{
+  assert(m.blocks_in_use <= blocks_in_use);
+  blocks_in_use = m.blocks_in_use;
+  bytes_in_use = m.bytes_in_use;
+  num_releases++;
+
+  if(blocks_in_use == 0)
+  {
+    cur = nullptr;
+    avail = 0;
+  }
+  else
+  {
+    blockt &block = blocks[blocks_in_use - 1];
+    cur = block.data + m.offset;
+    avail = block.size - m.offset;
+  }
+
+  // Keep one spare block, so that pushing and popping a small context
+  // repeatedly doesn't go back to the system each time
+  while(blocks.size() > blocks_in_use + 1)
+  {
+    delete[] blocks.back().data;
+    blocks.pop_back();
+  }
+}
+
+uint64_t smt_arenat::memory_usage() const
+{
+  uint64_t total = 0;
+  for(const auto &block : blocks)
+    total += block.size;
+  return total;
+}
+
+void smt_arenat::print_stats(std::ostream &out) const
+{
+  out << num_allocations << " allocations, " << bytes_in_use / 1024
+      << " KiB in use (peak " << peak_bytes_in_use / 1024 << " KiB), "
+      << memory_usage() / 1024 << " KiB in " << blocks.size() << " blocks, "
+      << num_releases << " releases";
+}
@@ -0,0 +1,91 @@
+#ifndef SOLVERS_SMT_SMT_ARENA_H_
+#define SOLVERS_SMT_SMT_ARENA_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+/** Bump allocator for the smt_asts and smt_sorts of a converter.
+ *  Conversion creates a very large number of small objects which live until
+ *  the context they were created in is popped, or until the converter is
+ *  destroyed. Rather than allocating and freeing each one, they are carved out
+ *  of large blocks in order, and freed in bulk: release() gives back
+ *  everything allocated since the corresponding mark().
+ *
+ *  The arena only manages memory. Objects in it must be destroyed by their
+ *  owner before their memory is released, if they need destroying at all.
+ *  @see smt_convt::live_asts */
+class smt_arenat
+{
+public:
+  /** A position in the arena, to release everything allocated after it */
+  struct markt
+  {
+    std::size_t blocks_in_use;
+    std::size_t offset;
+    uint64_t bytes_in_use;
+  };
+
+  smt_arenat();
+  ~smt_arenat();
+
+  smt_arenat(const smt_arenat &) = delete;
+  smt_arenat &operator=(const smt_arenat &) = delete;
+
+  void *allocate(std::size_t size)
+  {
+    size = (size + alignment - 1) & ~(alignment - 1);
+    if(size > avail)
+      return allocate_from_new_block(size);
+
+    void *p = cur;
+    cur += size;
+    avail -= size;
+    note_allocation(size);
+    return p;
+  }
+
+  markt mark() const;
+  void release(const markt &m);
+
+  /* Bytes taken from the system, whether in use or not */
+  uint64_t memory_usage() const;
+
+  void print_stats(std::ostream &out) const;
+
+protected:
+  static const std::size_t block_size = 64 * 1024;
+  static const std::size_t alignment = alignof(std::max_align_t);
+
+  struct blockt
+  {
+    char *data;
+    std::size_t size;
+  };
+
+  // The blocks in use are a prefix of this; the last of them is the one being
+  // carved up. Blocks past it are kept for reuse after a release.
+  std::vector<blockt> blocks;
+  std::size_t blocks_in_use;
+  char *cur;
+  std::size_t avail;
+
+  // Statistics
+  uint64_t bytes_in_use;
+  uint64_t peak_bytes_in_use;
+  uint64_t num_allocations;
+  uint64_t num_releases;
+
+  void *allocate_from_new_block(std::size_t size);
+
+  void note_allocation(std::size_t size)
+  {
+    bytes_in_use += size;
+    if(bytes_in_use > peak_bytes_in_use)
+      peak_bytes_in_use = bytes_in_use;
+    num_allocations++;
+  }
+};
+
+#endif /* SOLVERS_SMT_SMT_ARENA_H_ */
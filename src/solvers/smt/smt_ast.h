@@ -39,6 +39,17 @@ public:
   smt_ast(smt_convt *ctx, smt_sortt s);
   virtual ~smt_ast() = default;
 
+  /** ASTs live in their context's arena, and are created with
+   *  new(ctx) some_smt_ast(ctx, ...). The memory is released in bulk when the
+   *  context is popped, never by delete. */
+  static void *operator new(std::size_t size, smt_convt *ctx);
+  static void operator delete(void *, smt_convt *)
+  {
+  }
+  static void operator delete(void *)
+  {
+  }
+
   // "this" is the true operand.
   virtual smt_astt ite(smt_convt *ctx, smt_astt cond, smt_astt falseop) const;
 
@@ -137,7 +137,7 @@ void smt_convt::delete_all_asts()
 {
   // Erase all the remaining asts in the live ast vector.
   for(auto *ast : live_asts)
-    delete ast;
+    ast->~smt_ast();
   live_asts.clear();
 }
 
@@ -180,6 +180,7 @@ void smt_convt::push_ctx()
   renumber_map.push_back(renumber_map.back());
 
   live_asts_sizes.push_back(live_asts.size());
+  ast_arena_marks.push_back(ast_arena.mark());
 
   ctx_level++;
 }
@@ -197,19 +198,32 @@ void smt_convt::pop_ctx()
 
   ctx_level--;
 
-  // Go through all the asts created since the last push and delete them.
+  // Go through all the asts created since the last push and destroy them.
 
   for(unsigned int idx = live_asts_sizes.back(); idx < live_asts.size(); idx++)
-    delete live_asts[idx];
+    live_asts[idx]->~smt_ast();
 
-  // And reset the storage back to that point.
+  // And reset the storage back to that point, releasing their memory in one
+  // go.
   live_asts.resize(live_asts_sizes.back());
   live_asts_sizes.pop_back();
+  ast_arena.release(ast_arena_marks.back());
+  ast_arena_marks.pop_back();
 
   array_api->pop_array_ctx();
   tuple_api->pop_tuple_ctx();
 }
 
+void smt_convt::print_memstats(std::ostream &out) const
+{
+  out << "Solver conversion memory usage:\n";
+  out << "  ASTs: " << live_asts.size() << " live, ";
+  ast_arena.print_stats(out);
+  out << "\n  Sorts: " << sort_cache.size() << " cached, ";
+  sort_arena.print_stats(out);
+  out << "\n";
+}
+
 smt_astt smt_convt::invert_ast(smt_astt a)
 {
   assert(a->sort->id == SMT_SORT_BOOL);
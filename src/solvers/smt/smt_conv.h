@@ -8,6 +8,7 @@
 #include <cstdint>
 #include <solvers/prop/literal.h>
 #include <solvers/prop/pointer_logic.h>
+#include <solvers/smt/smt_arena.h>
 #include <util/irep2_utils.h>
 #include <util/message.h>
 #include <util/namespace.h>
@@ -139,7 +140,7 @@ public:
   smt_astt
   new_solver_ast(typename the_solver_ast::solver_ast_type ast, smt_sortt sort)
   {
-    return new the_solver_ast(this, ast, sort);
+    return new(this) the_solver_ast(this, ast, sort);
   }
 
   /** Primary constructor. After construction, smt_post_init must be called
@@ -175,6 +176,12 @@ public:
   virtual void push_ctx();
   /** Pop one context on the SMT assertion stack. */
   virtual void pop_ctx();
+  /** Whether popping a context also retracts the assertions made in it.
+   *  Solvers that only keep the converter's own caches in step don't. */
+  virtual bool supports_ctx() const
+  {
+    return false;
+  }
 
   /** Main interface to SMT conversion.
    *  Takes one expression, and converts it into the underlying SMT solver,
@@ -523,6 +530,9 @@ public:
   /** Method to print the SMT model */
   virtual void print_model();
 
+  /** Print how many ASTs and sorts were created, and the memory they take */
+  void print_memstats(std::ostream &out) const;
+
   /** @} */
 
   /** @{
@@ -858,6 +868,13 @@ public:
    *  contained when a push occurred. On pop, the live_asts vector is reset
    *  back to that point. */
   std::vector<unsigned int> live_asts_sizes;
+  /** Storage of the ASTs, released back to the matching mark when a context
+   *  is popped. */
+  smt_arenat ast_arena;
+  std::vector<smt_arenat::markt> ast_arena_marks;
+  /** Storage of the sorts. Sorts are cached across contexts, so they are
+   *  kept until the converter is destroyed. */
+  smt_arenat sort_arena;
 
   tuple_iface *tuple_api;
   array_iface *array_api;
@@ -876,4 +893,14 @@ extern inline smt_ast::smt_ast(smt_convt *ctx, smt_sortt s)
   ctx->live_asts.push_back(this);
 }
 
+extern inline void *smt_ast::operator new(std::size_t size, smt_convt *ctx)
+{
+  return ctx->ast_arena.allocate(size);
+}
+
+extern inline void *smt_sort::operator new(std::size_t size, smt_convt *ctx)
+{
+  return ctx->sort_arena.allocate(size);
+}
+
 #endif /* _ESBMC_PROP_SMT_SMT_CONV_H_ */
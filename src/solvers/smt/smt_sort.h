@@ -3,6 +3,8 @@
 
 #include <util/irep2_type.h>
 
+class smt_convt;
+
 /** Identifier for SMT sort kinds
  *  Each different kind of sort (i.e. arrays, bv's, bools, etc) gets its own
  *  identifier. To be able to describe multiple kinds at the same time, they
@@ -134,6 +136,17 @@ public:
 
   virtual ~smt_sort() = default;
 
+  /** Sorts are created with new(ctx) some_smt_sort(...), in an arena that
+   *  lives as long as the converter. They are never destroyed, their memory
+   *  is freed along with the converter. */
+  static void *operator new(std::size_t size, smt_convt *ctx);
+  static void operator delete(void *, smt_convt *)
+  {
+  }
+  static void operator delete(void *)
+  {
+  }
+
 private:
   /** Data size of the sort.
    * For bitvectors and floating-points this is the bit width,
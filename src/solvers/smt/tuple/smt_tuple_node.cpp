@@ -14,7 +14,7 @@ smt_astt smt_tuple_node_flattener::tuple_create(const expr2tc &structdef)
   // Add a . suffix because this is of tuple type.
   name += ".";
 
-  tuple_node_smt_ast *result = new tuple_node_smt_ast(
+  tuple_node_smt_ast *result = new(ctx) tuple_node_smt_ast(
     *this, ctx, ctx->convert_sort(structdef->type), name);
   result->elements.resize(structdef->get_num_sub_exprs());
 
@@ -40,7 +40,7 @@ smt_astt smt_tuple_node_flattener::tuple_fresh(smt_sortt s, std::string name)
     return array_conv.mk_array_symbol(name, s, subtype);
   }
 
-  return new tuple_node_smt_ast(*this, ctx, s, name);
+  return new(ctx) tuple_node_smt_ast(*this, ctx, s, name);
 }
 
 smt_astt
@@ -62,7 +62,7 @@ smt_tuple_node_flattener::mk_tuple_symbol(const std::string &name, smt_sortt s)
     name2 += ".";
 
   assert(s->id != SMT_SORT_ARRAY);
-  return new tuple_node_smt_ast(*this, ctx, s, name2);
+  return new(ctx) tuple_node_smt_ast(*this, ctx, s, name2);
 }
 
 smt_astt smt_tuple_node_flattener::mk_tuple_array_symbol(const expr2tc &expr)
@@ -218,7 +218,7 @@ smt_astt smt_tuple_node_flattener::tuple_array_of(
 {
   uint64_t elems = 1ULL << array_size;
   array_type2tc array_type(init_val->type, gen_ulong(elems), false);
-  smt_sortt array_sort = new smt_sort(
+  smt_sortt array_sort = new(ctx) smt_sort(
     SMT_SORT_ARRAY,
     array_type,
     array_size,
@@ -239,11 +239,11 @@ smt_sortt smt_tuple_node_flattener::mk_struct_sort(const type2tc &type)
       "interface");
     unsigned int dom_width = ctx->calculate_array_domain_width(arrtype);
 
-    return new smt_sort(
+    return new(ctx) smt_sort(
       SMT_SORT_ARRAY, type, dom_width, ctx->convert_sort(arrtype.subtype));
   }
 
-  return new smt_sort(SMT_SORT_STRUCT, type);
+  return new(ctx) smt_sort(SMT_SORT_STRUCT, type);
 }
 
 void smt_tuple_node_flattener::add_tuple_constraints_for_solving()
@@ -268,6 +268,10 @@ public:
 
   void push_ctx() override;
   void pop_ctx() override;
+  bool supports_ctx() const override
+  {
+    return true;
+  }
 
   // Members
   pid_t solver_proc_pid;
@@ -276,6 +280,11 @@ public:
   std::string solver_name;
   std::string solver_version;
 
+  // The solver process is returned to a pool when we're done with it, unless
+  // it reported an error, or belongs to the process we were forked from
+  bool solver_failed;
+  pid_t solver_owner;
+
   // Actual solving data
   // The set of symbols and their sorts.
 
@@ -913,7 +913,7 @@ smt_sortt yices_convt::mk_struct_sort(const type2tc &type)
 
   // We now have an array of types, ready for sort creation
   type_t tuple_sort = yices_tuple_type(def.members.size(), sorts.data());
-  return new solver_smt_sort<type_t>(SMT_SORT_STRUCT, tuple_sort, type);
+  return new(this) solver_smt_sort<type_t>(SMT_SORT_STRUCT, tuple_sort, type);
 }
 
 smt_astt yices_convt::tuple_create(const expr2tc &structdef)
@@ -1006,7 +1006,8 @@ smt_astt yices_convt::tuple_array_of(
     theterm = yices_update(theterm, 1, &idxterm, yast->a);
   }
 
-  smt_sortt retsort = new solver_smt_sort<type_t>(SMT_SORT_STRUCT, tuplearr);
+  smt_sortt retsort =
+    new(this) solver_smt_sort<type_t>(SMT_SORT_STRUCT, tuplearr);
   return new_ast(theterm, retsort);
 }
 
@@ -1066,27 +1067,28 @@ void yices_convt::print_model()
 
 smt_sortt yices_convt::mk_bool_sort()
 {
-  return new solver_smt_sort<type_t>(SMT_SORT_BOOL, yices_bool_type(), 1);
+  return new(this) solver_smt_sort<type_t>(SMT_SORT_BOOL, yices_bool_type(), 1);
 }
 
 smt_sortt yices_convt::mk_real_sort()
 {
-  return new solver_smt_sort<type_t>(SMT_SORT_REAL, yices_int_type());
+  return new(this) solver_smt_sort<type_t>(SMT_SORT_REAL, yices_int_type());
 }
 
 smt_sortt yices_convt::mk_int_sort()
 {
-  return new solver_smt_sort<type_t>(SMT_SORT_INT, yices_real_type());
+  return new(this) solver_smt_sort<type_t>(SMT_SORT_INT, yices_real_type());
 }
 
 smt_sortt yices_convt::mk_bv_sort(std::size_t width)
 {
-  return new solver_smt_sort<type_t>(SMT_SORT_BV, yices_bv_type(width), width);
+  return new(this) solver_smt_sort<type_t>(
+    SMT_SORT_BV, yices_bv_type(width), width);
 }
 
 smt_sortt yices_convt::mk_fbv_sort(std::size_t width)
 {
-  return new solver_smt_sort<type_t>(
+  return new(this) solver_smt_sort<type_t>(
     SMT_SORT_FIXEDBV, yices_bv_type(width), width);
 }
 
@@ -1096,19 +1098,20 @@ smt_sortt yices_convt::mk_array_sort(smt_sortt domain, smt_sortt range)
   auto range_sort = to_solver_smt_sort<type_t>(range);
 
   auto t = yices_function_type(1, &domain_sort->s, range_sort->s);
-  return new solver_smt_sort<type_t>(
+  return new(this) solver_smt_sort<type_t>(
     SMT_SORT_ARRAY, t, domain_sort->get_data_width(), range);
 }
 
 smt_sortt yices_convt::mk_bvfp_sort(std::size_t ew, std::size_t sw)
 {
-  return new solver_smt_sort<type_t>(
+  return new(this) solver_smt_sort<type_t>(
     SMT_SORT_BVFP, yices_bv_type(ew + sw + 1), ew + sw + 1, sw + 1);
 }
 
 smt_sortt yices_convt::mk_bvfp_rm_sort()
 {
-  return new solver_smt_sort<type_t>(SMT_SORT_BVFP_RM, yices_bv_type(3), 3);
+  return new(this) solver_smt_sort<type_t>(
+    SMT_SORT_BVFP_RM, yices_bv_type(3), 3);
 }
 
 void yices_smt_ast::dump() const
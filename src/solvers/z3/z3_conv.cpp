@@ -956,7 +956,7 @@ smt_sortt z3_convt::mk_struct_sort(const type2tc &type)
       &mk_tuple_decl,
       proj_decls.ptr()));
 
-  return new solver_smt_sort<z3::sort>(SMT_SORT_STRUCT, sort, type);
+  return new(this) solver_smt_sort<z3::sort>(SMT_SORT_STRUCT, sort, type);
 }
 
 smt_astt z3_smt_ast::update(
@@ -1283,13 +1283,13 @@ smt_sortt z3_convt::mk_fpbv_sort(const unsigned ew, const unsigned sw)
 {
   // We need to add an extra bit to the significand size,
   // as it has no hidden bit
-  return new solver_smt_sort<z3::sort>(
+  return new(this) solver_smt_sort<z3::sort>(
     SMT_SORT_FPBV, z3_ctx.fpa_sort(ew, sw + 1), ew + sw + 1, sw + 1);
 }
 
 smt_sortt z3_convt::mk_fpbv_rm_sort()
 {
-  return new solver_smt_sort<z3::sort>(
+  return new(this) solver_smt_sort<z3::sort>(
     SMT_SORT_FPBV_RM,
     z3::sort(z3_ctx, Z3_mk_fpa_rounding_mode_sort(z3_ctx)),
     3);
@@ -1297,39 +1297,41 @@ smt_sortt z3_convt::mk_fpbv_rm_sort()
 
 smt_sortt z3_convt::mk_bvfp_sort(std::size_t ew, std::size_t sw)
 {
-  return new solver_smt_sort<z3::sort>(
+  return new(this) solver_smt_sort<z3::sort>(
     SMT_SORT_BVFP, z3_ctx.bv_sort(ew + sw + 1), ew + sw + 1, sw + 1);
 }
 
 smt_sortt z3_convt::mk_bvfp_rm_sort()
 {
-  return new solver_smt_sort<z3::sort>(SMT_SORT_BVFP_RM, z3_ctx.bv_sort(3), 3);
+  return new(this) solver_smt_sort<z3::sort>(
+    SMT_SORT_BVFP_RM, z3_ctx.bv_sort(3), 3);
 }
 
 smt_sortt z3_convt::mk_bool_sort()
 {
-  return new solver_smt_sort<z3::sort>(SMT_SORT_BOOL, z3_ctx.bool_sort(), 1);
+  return new(this) solver_smt_sort<z3::sort>(
+    SMT_SORT_BOOL, z3_ctx.bool_sort(), 1);
 }
 
 smt_sortt z3_convt::mk_real_sort()
 {
-  return new solver_smt_sort<z3::sort>(SMT_SORT_REAL, z3_ctx.real_sort());
+  return new(this) solver_smt_sort<z3::sort>(SMT_SORT_REAL, z3_ctx.real_sort());
 }
 
 smt_sortt z3_convt::mk_int_sort()
 {
-  return new solver_smt_sort<z3::sort>(SMT_SORT_INT, z3_ctx.int_sort());
+  return new(this) solver_smt_sort<z3::sort>(SMT_SORT_INT, z3_ctx.int_sort());
 }
 
 smt_sortt z3_convt::mk_bv_sort(std::size_t width)
 {
-  return new solver_smt_sort<z3::sort>(
+  return new(this) solver_smt_sort<z3::sort>(
     SMT_SORT_BV, z3_ctx.bv_sort(width), width);
 }
 
 smt_sortt z3_convt::mk_fbv_sort(std::size_t width)
 {
-  return new solver_smt_sort<z3::sort>(
+  return new(this) solver_smt_sort<z3::sort>(
     SMT_SORT_FIXEDBV, z3_ctx.bv_sort(width), width);
 }
 
@@ -1339,7 +1341,7 @@ smt_sortt z3_convt::mk_array_sort(smt_sortt domain, smt_sortt range)
   auto range_sort = to_solver_smt_sort<z3::sort>(range);
 
   auto t = z3_ctx.array_sort(domain_sort->s, range_sort->s);
-  return new solver_smt_sort<z3::sort>(
+  return new(this) solver_smt_sort<z3::sort>(
     SMT_SORT_ARRAY, t, domain->get_data_width(), range);
 }
 
@@ -0,0 +1,392 @@
+/*******************************************************************\
+
+Module: Chunked vector with stable element addresses
+
+\*******************************************************************/
+
+#ifndef CPROVER_UTIL_CHUNKED_VECTOR_H
+#define CPROVER_UTIL_CHUNKED_VECTOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A sequence container that stores its elements in fixed-size chunks. Pushing
+// a new element never moves the existing ones, so references remain valid for
+// the lifetime of the element, and elements are addressed by index in O(1).
+//
+// Iterators are (container, index) pairs. The end() iterator is a sentinel
+// that stays the end of the sequence when new elements are appended, which
+// mirrors the behaviour of std::list iterators that callers storing
+// "progress" iterators rely on. As with std::list, incrementing end() wraps
+// around to begin().
+template <typename T, std::size_t chunk_size = 256>
+class chunked_vectort
+{
+public:
+  typedef T value_type;
+  typedef std::size_t size_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+
+  static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+  template <bool is_const>
+  class iteratort
+  {
+  public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<is_const, const T *, T *>::type pointer;
+    typedef typename std::conditional<is_const, const T &, T &>::type reference;
+    typedef typename std::
+      conditional<is_const, const chunked_vectort *, chunked_vectort *>::type
+        containert;
+
+    iteratort() : container(nullptr), idx(npos)
+    {
+    }
+
+    iteratort(containert c, size_type i) : container(c), idx(i)
+    {
+    }
+
+    // Allow iterator -> const_iterator conversion
+    template <bool other_const, typename = typename std::enable_if<
+                                  is_const && !other_const>::type>
+    iteratort(const iteratort<other_const> &ref)
+      : container(ref.container), idx(ref.idx)
+    {
+    }
+
+    reference operator*() const
+    {
+      return (*container)[idx];
+    }
+
+    pointer operator->() const
+    {
+      return &(*container)[idx];
+    }
+
+    iteratort &operator++()
+    {
+      if(idx == npos)
+        idx = container->empty() ? npos : 0;
+      else if(++idx == container->size())
+        idx = npos;
+      return *this;
+    }
+
+    iteratort operator++(int)
+    {
+      iteratort tmp(*this);
+      ++*this;
+      return tmp;
+    }
+
+    iteratort &operator--()
+    {
+      if(idx == npos)
+        idx = container->size() - 1;
+      else
+        --idx;
+      return *this;
+    }
+
+    iteratort operator--(int)
+    {
+      iteratort tmp(*this);
+      --*this;
+      return tmp;
+    }
+
+    template <bool other_const>
+    bool operator==(const iteratort<other_const> &ref) const
+    {
+      return idx == ref.idx;
+    }
+
+    template <bool other_const>
+    bool operator!=(const iteratort<other_const> &ref) const
+    {
+      return idx != ref.idx;
+    }
+
+    // Sequence order; end() sorts after every element.
+    template <bool other_const>
+    bool operator<(const iteratort<other_const> &ref) const
+    {
+      return idx < ref.idx;
+    }
+
+    // Position in the container, or npos for end().
+    size_type index() const
+    {
+      return idx;
+    }
+
+  private:
+    template <bool>
+    friend class iteratort;
+    friend class chunked_vectort;
+
+    containert container;
+    size_type idx;
+  };
+
+  typedef iteratort<false> iterator;
+  typedef iteratort<true> const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  chunked_vectort() : num_elems(0)
+  {
+  }
+
+  chunked_vectort(const chunked_vectort &ref) : num_elems(0)
+  {
+    for(const T &elem : ref)
+      push_back(elem);
+  }
+
+  chunked_vectort(chunked_vectort &&ref) noexcept
+    : chunks(std::move(ref.chunks)), num_elems(ref.num_elems)
+  {
+    ref.chunks.clear();
+    ref.num_elems = 0;
+  }
+
+  chunked_vectort &operator=(const chunked_vectort &ref)
+  {
+    if(this != &ref)
+    {
+      chunked_vectort tmp(ref);
+      swap(tmp);
+    }
+    return *this;
+  }
+
+  chunked_vectort &operator=(chunked_vectort &&ref) noexcept
+  {
+    swap(ref);
+    return *this;
+  }
+
+  ~chunked_vectort()
+  {
+    clear();
+    release_chunks(0);
+  }
+
+  void swap(chunked_vectort &ref)
+  {
+    chunks.swap(ref.chunks);
+    std::swap(num_elems, ref.num_elems);
+  }
+
+  size_type size() const
+  {
+    return num_elems;
+  }
+
+  bool empty() const
+  {
+    return num_elems == 0;
+  }
+
+  // Number of chunks currently allocated, in use or not.
+  size_type num_chunks() const
+  {
+    return chunks.size();
+  }
+
+  // Bytes reserved for element storage, excluding any heap memory owned by
+  // the elements themselves.
+  size_type capacity_bytes() const
+  {
+    return chunks.size() * chunk_size * sizeof(T) +
+           chunks.capacity() * sizeof(T *);
+  }
+
+  T &operator[](size_type i)
+  {
+    assert(i < num_elems);
+    return chunks[i / chunk_size][i % chunk_size];
+  }
+
+  const T &operator[](size_type i) const
+  {
+    assert(i < num_elems);
+    return chunks[i / chunk_size][i % chunk_size];
+  }
+
+  T &back()
+  {
+    return (*this)[num_elems - 1];
+  }
+
+  const T &back() const
+  {
+    return (*this)[num_elems - 1];
+  }
+
+  T &front()
+  {
+    return (*this)[0];
+  }
+
+  const T &front() const
+  {
+    return (*this)[0];
+  }
+
+  template <typename... Args>
+  T &emplace_back(Args &&... args)
+  {
+    T *slot = next_slot();
+    new(slot) T(std::forward<Args>(args)...);
+    ++num_elems;
+    return *slot;
+  }
+
+  void push_back(const T &elem)
+  {
+    emplace_back(elem);
+  }
+
+  void push_back(T &&elem)
+  {
+    emplace_back(std::move(elem));
+  }
+
+  // Destroy every element from index n onwards. Chunks are kept around so
+  // that a following push does not need to allocate again.
+  void truncate(size_type n)
+  {
+    while(num_elems > n)
+    {
+      --num_elems;
+      chunks[num_elems / chunk_size][num_elems % chunk_size].~T();
+    }
+  }
+
+  void clear()
+  {
+    truncate(0);
+  }
+
+  // Only erasing a suffix is supported, which is what context popping needs.
+  iterator erase(iterator first, iterator last)
+  {
+    assert(last.idx == npos && "chunked_vectort can only erase a suffix");
+    (void)last;
+    if(first.idx != npos)
+      truncate(first.idx);
+    return end();
+  }
+
+  // Remove every element matching the predicate, keeping the relative order
+  // of the survivors. Returns the number of elements removed.
+  template <typename Pred>
+  size_type remove_if(Pred pred)
+  {
+    size_type out = 0;
+    for(size_type in = 0; in < num_elems; ++in)
+    {
+      T &elem = (*this)[in];
+      if(pred(elem))
+        continue;
+
+      if(out != in)
+        (*this)[out] = std::move(elem);
+      ++out;
+    }
+
+    size_type removed = num_elems - out;
+    truncate(out);
+    return removed;
+  }
+
+  iterator begin()
+  {
+    return iterator(this, empty() ? npos : 0);
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(this, empty() ? npos : 0);
+  }
+
+  iterator end()
+  {
+    return iterator(this, npos);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(this, npos);
+  }
+
+  reverse_iterator rbegin()
+  {
+    return reverse_iterator(end());
+  }
+
+  const_reverse_iterator rbegin() const
+  {
+    return const_reverse_iterator(end());
+  }
+
+  reverse_iterator rend()
+  {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rend() const
+  {
+    return const_reverse_iterator(begin());
+  }
+
+  iterator iterator_at(size_type i)
+  {
+    return iterator(this, i < num_elems ? i : npos);
+  }
+
+  const_iterator iterator_at(size_type i) const
+  {
+    return const_iterator(this, i < num_elems ? i : npos);
+  }
+
+private:
+  T *next_slot()
+  {
+    size_type chunk = num_elems / chunk_size;
+    if(chunk == chunks.size())
+      chunks.push_back(
+        static_cast<T *>(::operator new(chunk_size * sizeof(T))));
+    return chunks[chunk] + (num_elems % chunk_size);
+  }
+
+  void release_chunks(size_type keep)
+  {
+    for(size_type i = keep; i < chunks.size(); ++i)
+      ::operator delete(chunks[i]);
+    chunks.resize(keep);
+  }
+
+  std::vector<T *> chunks;
+  size_type num_elems;
+};
+
+template <typename T, std::size_t chunk_size>
+constexpr typename chunked_vectort<T, chunk_size>::size_type
+  chunked_vectort<T, chunk_size>::npos;
+
+#endif
@@ -0,0 +1,217 @@
+/*******************************************************************\
+
+Module: Vector with copy-on-write elements
+
+\*******************************************************************/
+
+#ifndef CPROVER_UTIL_COW_VECTOR_H
+#define CPROVER_UTIL_COW_VECTOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// A sequence container whose elements are shared between copies of it.
+// Copying the container only copies a pointer per element; an element is
+// copied the first time it's accessed through a non-const reference while
+// another container still refers to it. Read-only access, through a const
+// container or const_iterators, never copies anything.
+//
+// References to elements obtained through a non-const access remain valid
+// until the container is copied: after that, writing through them would
+// modify the copy too.
+template <typename T>
+class cow_vectort
+{
+public:
+  typedef T value_type;
+  typedef std::size_t size_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+
+  template <bool is_const>
+  class iteratort
+  {
+  public:
+    typedef std::bidirectional_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef typename std::conditional<is_const, const T *, T *>::type pointer;
+    typedef typename std::conditional<is_const, const T &, T &>::type reference;
+    typedef
+      typename std::conditional<is_const, const cow_vectort *, cow_vectort *>::
+        type containert;
+
+    iteratort() : container(nullptr), idx(0)
+    {
+    }
+
+    iteratort(containert c, size_type i) : container(c), idx(i)
+    {
+    }
+
+    // Allow iterator -> const_iterator conversion
+    template <bool other_const, typename = typename std::enable_if<
+                                  is_const && !other_const>::type>
+    iteratort(const iteratort<other_const> &ref)
+      : container(ref.container), idx(ref.idx)
+    {
+    }
+
+    // Dereferencing a non-const iterator unshares the element
+    reference operator*() const
+    {
+      return (*container)[idx];
+    }
+
+    pointer operator->() const
+    {
+      return &(*container)[idx];
+    }
+
+    iteratort &operator++()
+    {
+      ++idx;
+      return *this;
+    }
+
+    iteratort operator++(int)
+    {
+      iteratort tmp(*this);
+      ++idx;
+      return tmp;
+    }
+
+    iteratort &operator--()
+    {
+      --idx;
+      return *this;
+    }
+
+    iteratort operator--(int)
+    {
+      iteratort tmp(*this);
+      --idx;
+      return tmp;
+    }
+
+    template <bool other_const>
+    bool operator==(const iteratort<other_const> &ref) const
+    {
+      return idx == ref.idx;
+    }
+
+    template <bool other_const>
+    bool operator!=(const iteratort<other_const> &ref) const
+    {
+      return idx != ref.idx;
+    }
+
+  private:
+    template <bool>
+    friend class iteratort;
+
+    containert container;
+    size_type idx;
+  };
+
+  typedef iteratort<false> iterator;
+  typedef iteratort<true> const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+  bool empty() const
+  {
+    return elems.empty();
+  }
+
+  size_type size() const
+  {
+    return elems.size();
+  }
+
+  const T &operator[](size_type i) const
+  {
+    assert(i < elems.size());
+    return *elems[i];
+  }
+
+  T &operator[](size_type i)
+  {
+    assert(i < elems.size());
+    std::shared_ptr<T> &elem = elems[i];
+    if(elem.use_count() > 1)
+      elem = std::make_shared<T>(*elem);
+    return *elem;
+  }
+
+  const T &back() const
+  {
+    return (*this)[elems.size() - 1];
+  }
+
+  T &back()
+  {
+    return (*this)[elems.size() - 1];
+  }
+
+  template <typename... Args>
+  void emplace_back(Args &&... args)
+  {
+    elems.push_back(std::make_shared<T>(std::forward<Args>(args)...));
+  }
+
+  void pop_back()
+  {
+    elems.pop_back();
+  }
+
+  iterator begin()
+  {
+    return iterator(this, 0);
+  }
+
+  iterator end()
+  {
+    return iterator(this, elems.size());
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(this, 0);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(this, elems.size());
+  }
+
+  reverse_iterator rbegin()
+  {
+    return reverse_iterator(end());
+  }
+
+  reverse_iterator rend()
+  {
+    return reverse_iterator(begin());
+  }
+
+  const_reverse_iterator rbegin() const
+  {
+    return const_reverse_iterator(end());
+  }
+
+  const_reverse_iterator rend() const
+  {
+    return const_reverse_iterator(begin());
+  }
+
+protected:
+  std::vector<std::shared_ptr<T>> elems;
+};
+
+#endif
@@ -109,8 +109,7 @@ void irept::remove_ref(dt *old_data)
   std::cout << "R: " << old_data << " " << old_data->ref_count << std::endl;
 #endif
 
-  old_data->ref_count--;
-  if(old_data->ref_count == 0)
+  if(--old_data->ref_count == 0)
   {
 #ifdef IREP_DEBUG
     std::cout << "D: " << pretty() << std::endl;
@@ -9,6 +9,9 @@ Author: Daniel Kroening, kroening@kroening.com
 #ifndef CPROVER_IREP_H
 #define CPROVER_IREP_H
 
+#ifdef IREP_ATOMIC_REF_COUNT
+#include <atomic>
+#endif
 #include <cassert>
 #include <list>
 #include <map>
@@ -1260,7 +1263,13 @@ public:
   {
   public:
 #ifdef SHARING
+#ifdef IREP_ATOMIC_REF_COUNT
+    // Atomic, so that ireps shared between functions can be copied and
+    // released by passes running on several threads
+    std::atomic<unsigned> ref_count;
+#else
     unsigned ref_count;
+#endif
 #endif
 
     dstring data;
@@ -1289,6 +1298,15 @@ public:
     dt() : ref_count(1)
     {
     }
+
+    dt(const dt &d)
+      : ref_count(1),
+        data(d.data),
+        named_sub(d.named_sub),
+        comments(d.comments),
+        sub(d.sub)
+    {
+    }
 #else
     dt()
     {
@@ -305,13 +305,18 @@ auto type2t_traits<Args...>::make_contained(typename Args::result_type... args)
 /*************************** Base expr2t definitions **************************/
 
 expr2t::expr2t(const type2tc &_type, expr_ids id)
-  : std::enable_shared_from_this<expr2t>(), expr_id(id), type(_type), crc_val(0)
+  : std::enable_shared_from_this<expr2t>(),
+    expr_id(id),
+    simplified(false),
+    type(_type),
+    crc_val(0)
 {
 }
 
 expr2t::expr2t(const expr2t &ref)
   : std::enable_shared_from_this<expr2t>(),
     expr_id(ref.expr_id),
+    simplified(false),
     type(ref.type),
     crc_val(ref.crc_val)
 {
@@ -254,7 +254,7 @@ public:
   {
     detach();
     T *tmp = std::shared_ptr<T>::get();
-    tmp->crc_val = 0;
+    tmp->invalidate_cached();
     return tmp;
   }
 
@@ -262,7 +262,7 @@ public:
   {
     detach();
     T *tmp = std::shared_ptr<T>::get();
-    tmp->crc_val = 0;
+    tmp->invalidate_cached();
     return tmp;
   }
 
@@ -490,6 +490,13 @@ public:
   type_ids type_id;
 
   mutable size_t crc_val;
+
+  /** Forget anything computed from the contents of this type, before they
+   *  are modified. */
+  void invalidate_cached() const
+  {
+    crc_val = 0;
+  }
 };
 
 /** Fetch identifying name for a type.
@@ -758,10 +765,22 @@ public:
   /** Instance of expr_ids recording tihs exprs type. */
   const expr_ids expr_id;
 
+  /** Whether simplify() is known to leave this expr as it is. Lives in the
+   *  padding after expr_id. */
+  mutable bool simplified;
+
   /** Type of this expr. All exprs have a type. */
   type2tc type;
 
   mutable size_t crc_val;
+
+  /** Forget anything computed from the contents of this expr, before they
+   *  are modified. */
+  void invalidate_cached() const
+  {
+    crc_val = 0;
+    simplified = false;
+  }
 };
 
 inline bool is_nil_expr(const expr2tc &exp)
@@ -1440,6 +1459,10 @@ T2 *get_pointer(esbmct::something2tc<T1, T2, T3, T4, T5, T6> const &p)
 
 inline bool operator==(const type2tc &a, const type2tc &b)
 {
+  // Same node, or both nil. Always the case for equal hash-consed types.
+  if(a.get() == b.get())
+    return true;
+
   // Handle nil ireps
   if(is_nil_type(a) && is_nil_type(b))
     return true;
@@ -1456,6 +1479,9 @@ inline bool operator!=(const type2tc &a, const type2tc &b)
 
 inline bool operator<(const type2tc &a, const type2tc &b)
 {
+  if(a.get() == b.get())
+    return false;
+
   if(is_nil_type(a))        // nil is lower than non-nil
     return !is_nil_type(b); // true if b is non-nil, so a is lower
   if(is_nil_type(b))
@@ -1474,6 +1500,10 @@ inline bool operator>(const type2tc &a, const type2tc &b)
 
 inline bool operator==(const expr2tc &a, const expr2tc &b)
 {
+  // Same node, or both nil. Always the case for equal hash-consed exprs.
+  if(a.get() == b.get())
+    return true;
+
   if(is_nil_expr(a) && is_nil_expr(b))
     return true;
   if(is_nil_expr(a) || is_nil_expr(b))
@@ -1489,6 +1519,9 @@ inline bool operator!=(const expr2tc &a, const expr2tc &b)
 
 inline bool operator<(const expr2tc &a, const expr2tc &b)
 {
+  if(a.get() == b.get())
+    return false;
+
   if(is_nil_expr(a))        // nil is lower than non-nil
     return !is_nil_expr(b); // true if b is non-nil, so a is lower
   if(is_nil_expr(b))
@@ -0,0 +1,201 @@
+#include <atomic>
+#include <mutex>
+#include <unordered_set>
+#include <util/irep2_hash_cons.h>
+
+namespace
+{
+/** Set of canonical nodes. It is split into shards by crc, each with its own
+ *  lock, so that several threads can hash-cons at once.
+ *
+ *  The crc of a node is computed by the thread interning it, before the node
+ *  can be seen by any other, and is stored next to it: the table never asks
+ *  a canonical node for its crc again, so the lazily cached crc_val of shared
+ *  nodes is never written. */
+template <class T>
+class unique_tablet
+{
+public:
+  unique_tablet() : hits(0), misses(0)
+  {
+  }
+
+  /** Fetch the canonical node equal to ref, whose crc is crc.
+   *  @return Whether there was one, in which case it is stored in result. */
+  bool lookup(const T &ref, size_t crc, T &result)
+  {
+    shardt &shard = shards[crc % num_shards];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.nodes.find(entryt{crc, ref});
+    if(it == shard.nodes.end())
+      return false;
+
+    hits++;
+    result = it->node;
+    return true;
+  }
+
+  /** Make ref canonical, unless an equal node got there first.
+   *  @return The canonical node. */
+  T insert(const T &ref, size_t crc)
+  {
+    shardt &shard = shards[crc % num_shards];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto res = shard.nodes.insert(entryt{crc, ref});
+    if(res.second)
+      misses++;
+    else
+      hits++;
+    return res.first->node;
+  }
+
+  size_t collect()
+  {
+    size_t released = 0;
+    for(auto &shard : shards)
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      for(auto it = shard.nodes.begin(); it != shard.nodes.end();)
+      {
+        if(it->node.use_count() == 1)
+        {
+          it = shard.nodes.erase(it);
+          released++;
+        }
+        else
+          ++it;
+      }
+    }
+    return released;
+  }
+
+  size_t size()
+  {
+    size_t total = 0;
+    for(auto &shard : shards)
+    {
+      std::lock_guard<std::mutex> lock(shard.mutex);
+      total += shard.nodes.size();
+    }
+    return total;
+  }
+
+  std::atomic<size_t> hits;
+  std::atomic<size_t> misses;
+
+protected:
+  static const unsigned int num_shards = 64;
+
+  struct entryt
+  {
+    size_t crc;
+    T node;
+
+    bool operator==(const entryt &ref) const
+    {
+      return crc == ref.crc && node == ref.node;
+    }
+  };
+
+  struct entry_hash
+  {
+    size_t operator()(const entryt &entry) const
+    {
+      return entry.crc;
+    }
+  };
+
+  struct shardt
+  {
+    std::mutex mutex;
+    std::unordered_set<entryt, entry_hash> nodes;
+  };
+
+  shardt shards[num_shards];
+};
+
+unique_tablet<expr2tc> &expr_table()
+{
+  static unique_tablet<expr2tc> table;
+  return table;
+}
+
+unique_tablet<type2tc> &type_table()
+{
+  static unique_tablet<type2tc> table;
+  return table;
+}
+} // namespace
+
+type2tc hash_cons(const type2tc &type)
+{
+  if(is_nil_type(type))
+    return type;
+
+  // Types are small and few, they're compared structurally when interned
+  return type_table().insert(type, type.crc());
+}
+
+expr2tc hash_cons(const expr2tc &expr)
+{
+  if(is_nil_expr(expr))
+    return expr;
+
+  // Canonical nodes, and anything equal to one, stop the walk here. This is
+  // what keeps hash-consing an expression that shares most of its nodes
+  // with the table cheap.
+  expr2tc result;
+  if(expr_table().lookup(expr, expr.crc(), result))
+    return result;
+
+  // Otherwise make the children canonical first, so that the table only
+  // ever holds nodes made of canonical nodes
+  unsigned int num_ops = expr->get_num_sub_exprs();
+  std::vector<expr2tc> ops(num_ops);
+  type2tc type = hash_cons(expr->type);
+  bool changed = type.get() != expr->type.get();
+  for(unsigned int i = 0; i < num_ops; i++)
+  {
+    const expr2tc *op = expr->get_sub_expr(i);
+    ops[i] = hash_cons(*op);
+    changed |= ops[i].get() != op->get();
+  }
+
+  if(!changed)
+    return expr_table().insert(expr, expr.crc());
+
+  expr2tc copy = expr;
+  expr2t *node = copy.get();
+  node->type = type;
+  for(unsigned int i = 0; i < num_ops; i++)
+    *node->get_sub_expr_nc(i) = ops[i];
+
+  // Only this thread can see the copy until it's in the table
+  return expr_table().insert(copy, copy.crc());
+}
+
+size_t hash_cons_collect()
+{
+  // Releasing a node may leave its children only referenced by the table
+  size_t total = 0, released;
+  do
+  {
+    released = expr_table().collect();
+    total += released;
+  } while(released != 0);
+
+  return total + type_table().collect();
+}
+
+void hash_cons_stats(std::ostream &out)
+{
+  unique_tablet<expr2tc> &exprs = expr_table();
+  unique_tablet<type2tc> &types = type_table();
+
+  out << "Hash-consing: " << exprs.size() << " unique exprs (" << exprs.hits
+      << " hits, " << exprs.misses << " misses), " << types.size()
+      << " unique types (" << types.hits << " hits, " << types.misses
+      << " misses)\n";
+}
@@ -0,0 +1,32 @@
+#ifndef UTIL_IREP2_HASH_CONS_H_
+#define UTIL_IREP2_HASH_CONS_H_
+
+/** @file irep2_hash_cons.h
+ *  Opt-in hash-consing of irep2 expressions and types.
+ *
+ *  hash_cons returns the canonical copy of an expression: structurally equal
+ *  expressions that have been hash-consed share one expr2t object, as do all
+ *  of their sub-expressions and types. Equality of canonical expressions is
+ *  then decided by the pointer comparison in operator==, and their crc is
+ *  computed once, when they enter the table.
+ *
+ *  The unique table holds a reference to every canonical node, so their
+ *  use_count never drops to one and copy-on-write keeps them immutable:
+ *  modifying a canonical expression detaches a private copy as usual.
+ *  Nodes nobody else refers to any more are only released by
+ *  hash_cons_collect.
+ */
+
+#include <ostream>
+#include <util/irep2.h>
+
+expr2tc hash_cons(const expr2tc &expr);
+type2tc hash_cons(const type2tc &type);
+
+/** Drop every canonical node that is only referenced by the unique table.
+ *  @return Number of nodes released. */
+size_t hash_cons_collect();
+
+void hash_cons_stats(std::ostream &out);
+
+#endif /* UTIL_IREP2_HASH_CONS_H_ */
@@ -3,6 +3,7 @@
 
 #include <util/irep2_expr.h>
 #include <util/c_types.h>
+#include <util/simplify_cache.h>
 
 /** Test whether type is an integer. */
 inline bool is_bv_type(const type2tc &t)
@@ -261,7 +262,7 @@ inline const type2tc &get_base_array_subtype(const type2tc &type)
 
 inline bool simplify(expr2tc &expr)
 {
-  expr2tc tmp = expr->simplify();
+  expr2tc tmp = simplify_memoised(expr);
   if(!is_nil_expr(tmp))
   {
     expr = tmp;
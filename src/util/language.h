@@ -56,6 +56,13 @@ public:
     const std::string &module,
     message_handlert &message_handler) = 0;
 
+  // whether typecheck only depends on the currently parsed file, in which
+  // case files can be parsed and type checked apart and linked afterwards
+  virtual bool typechecks_independently() const
+  {
+    return false;
+  }
+
   // language id / description
   virtual std::string id() const
   {
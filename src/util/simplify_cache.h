@@ -0,0 +1,32 @@
+#ifndef UTIL_SIMPLIFY_CACHE_H_
+#define UTIL_SIMPLIFY_CACHE_H_
+
+/** @file simplify_cache.h
+ *  Memoisation of expr2t::simplify.
+ *
+ *  Symex simplifies each assignment as it's made, and assignments keep being
+ *  built out of the values of earlier ones, so the same subtrees are walked
+ *  over and over again. Two things cut that short:
+ *   - exprs that simplify to nothing are marked as such (expr2t::simplified);
+ *     the mark is dropped when the expr is modified or copied;
+ *   - the results of simplifying exprs with operands are kept in a table, so
+ *     that structurally equal exprs, even ones that aren't the same node, are
+ *     only simplified once.
+ *
+ *  The table belongs to the calling thread, and is emptied whenever it grows
+ *  too large, as it keeps the exprs in it alive.
+ */
+
+#include <ostream>
+#include <util/irep2.h>
+
+/** Simplify expr, or fetch the result of simplifying an equal expr.
+ *  @return Same as expr2t::simplify: nil if nothing could be simplified. */
+expr2tc simplify_memoised(const expr2tc &expr);
+
+/** Empty the table and reset the counters, at the start of a run */
+void simplify_cache_clear();
+
+void simplify_cache_stats(std::ostream &out);
+
+#endif /* UTIL_SIMPLIFY_CACHE_H_ */
@@ -1,13 +1,104 @@
 #include <climits>
 #include <cstring>
+#include <unordered_map>
 #include <util/arith_tools.h>
 #include <util/base_type.h>
 #include <util/c_types.h>
 #include <util/expr_util.h>
 #include <util/irep2.h>
 #include <util/irep2_utils.h>
+#include <util/simplify_cache.h>
 #include <util/type_byte_size.h>
 
+namespace
+{
+class simplify_cachet
+{
+public:
+  simplify_cachet()
+  {
+    clear();
+  }
+
+  void clear()
+  {
+    memo.clear();
+    hits = misses = marked = flushes = 0;
+  }
+
+  std::unordered_map<expr2tc, expr2tc, irep2_hash> memo;
+
+  uint64_t hits;
+  uint64_t misses;
+  // Lookups that stopped at an expr marked as already simplified
+  uint64_t marked;
+  // Number of times the table was emptied for growing too large
+  uint64_t flushes;
+
+  static const size_t max_entries = 1 << 18;
+};
+
+simplify_cachet &simplify_cache()
+{
+  static thread_local simplify_cachet cache;
+  return cache;
+}
+} // namespace
+
+expr2tc simplify_memoised(const expr2tc &expr)
+{
+  simplify_cachet &cache = simplify_cache();
+  if(expr->simplified)
+  {
+    cache.marked++;
+    return expr2tc();
+  }
+
+  // Leaves are cheap to simplify, and there are too many of them to keep
+  if(expr->get_num_sub_exprs() == 0)
+  {
+    expr2tc res = expr->simplify();
+    expr->simplified = is_nil_expr(res);
+    return res;
+  }
+
+  auto it = cache.memo.find(expr);
+  if(it != cache.memo.end())
+  {
+    cache.hits++;
+    return it->second;
+  }
+
+  cache.misses++;
+  expr2tc res = expr->simplify();
+  expr->simplified = is_nil_expr(res);
+
+  if(cache.memo.size() >= simplify_cachet::max_entries)
+  {
+    cache.memo.clear();
+    cache.flushes++;
+  }
+  cache.memo.emplace(expr, res);
+  return res;
+}
+
+void simplify_cache_clear()
+{
+  simplify_cache().clear();
+}
+
+void simplify_cache_stats(std::ostream &out)
+{
+  simplify_cachet &cache = simplify_cache();
+  uint64_t lookups = cache.hits + cache.misses + cache.marked;
+  out << "Simplification cache: " << cache.hits << " hits, " << cache.marked
+      << " already simplified, " << cache.misses << " misses";
+  if(lookups != 0)
+    out << " (" << (100 * (cache.hits + cache.marked) / lookups) << "% saved)";
+  out << ", " << cache.memo.size() << " entries, " << cache.flushes
+      << " flushes";
+}
+
 expr2tc expr2t::do_simplify() const
 {
   return expr2tc();
@@ -35,7 +126,7 @@ expr2tc expr2t::simplify() const
       // Woot, we simplified some of this. It may have _additional_ fields that
       // need to get simplified (member2ts in arrays for example), so invoke the
       // simplifier again, to hit those potential subfields.
-      expr2tc res2 = res->simplify();
+      expr2tc res2 = simplify_memoised(res);
 
       // If we simplified even further, return res2; otherwise res.
       if(is_nil_expr(res2))
@@ -46,21 +137,18 @@ expr2tc expr2t::simplify() const
 
     // Try simplifying all the sub-operands.
     bool changed = false;
-    std::list<expr2tc> newoperands;
+    unsigned int num_ops = get_num_sub_exprs();
+    std::vector<expr2tc> newoperands(num_ops);
 
-    for(unsigned int idx = 0; idx < get_num_sub_exprs(); idx++)
+    for(unsigned int idx = 0; idx < num_ops; idx++)
     {
       const expr2tc *e = get_sub_expr(idx);
-      expr2tc tmp;
-
       if(!is_nil_expr(*e))
       {
-        tmp = e->simplify();
-        if(!is_nil_expr(tmp))
+        newoperands[idx] = simplify_memoised(*e);
+        if(!is_nil_expr(newoperands[idx]))
           changed = true;
       }
-
-      newoperands.push_back(tmp);
     }
 
     if(changed == false)
@@ -72,7 +160,7 @@ expr2tc expr2t::simplify() const
 
     // An operand has been changed; clone ourselves and update.
     expr2tc new_us = clone();
-    std::list<expr2tc>::iterator it2 = newoperands.begin();
+    std::vector<expr2tc>::iterator it2 = newoperands.begin();
     new_us->Foreach_operand([&it2](expr2tc &e) {
       if((*it2) == nullptr)
         ; // No change in operand;
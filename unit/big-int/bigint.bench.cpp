@@ -0,0 +1,168 @@
+/*******************************************************************
+ Module: BigInt microbenchmarks
+
+ Bench Plan:
+   - Construction, copies and moves of small values
+   - Arithmetic and comparisons on values that fit in 64 bits
+   - Arithmetic on values that don't
+   - Conversion to strings
+
+ Run with a repetition factor as the first argument, 1 by default. Every
+ benchmark prints the time per operation, and a checksum so that the work
+ can't be optimised away.
+ \*******************************************************************/
+
+#include <big-int/bigint.hh>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace
+{
+unsigned long repeat = 1;
+
+template <class F>
+void bench(const char *name, unsigned long ops, F f)
+{
+  ops *= repeat;
+  auto start = std::chrono::steady_clock::now();
+  int64_t checksum = f(ops);
+  auto stop = std::chrono::steady_clock::now();
+
+  double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+  printf(
+    "%-28s %10.2f ns/op  (checksum %lld)\n",
+    name,
+    ns / ops,
+    (long long)checksum);
+}
+
+BigInt big_value()
+{
+  // Well above 64 bits
+  return BigInt("123456789012345678901234567890123456789");
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+  if(argc > 1)
+    repeat = strtoul(argv[1], nullptr, 10);
+
+  bench("construct int", 10000000, [](unsigned long n) {
+    int64_t sum = 0;
+    for(unsigned long i = 0; i < n; i++)
+    {
+      BigInt x((int)i);
+      sum += x.is_odd();
+    }
+    return sum;
+  });
+
+  bench("copy", 10000000, [](unsigned long n) {
+    BigInt x(123456789);
+    int64_t sum = 0;
+    for(unsigned long i = 0; i < n; i++)
+    {
+      BigInt y(x);
+      sum += y.is_odd();
+    }
+    return sum;
+  });
+
+  bench("vector of BigInt", 100000, [](unsigned long n) {
+    int64_t sum = 0;
+    for(unsigned long i = 0; i < n; i++)
+    {
+      std::vector<BigInt> v;
+      for(int j = 0; j < 64; j++)
+        v.push_back(BigInt(j));
+      sum += v.size();
+    }
+    return sum;
+  });
+
+  bench("add small", 10000000, [](unsigned long n) {
+    BigInt x(0);
+    for(unsigned long i = 0; i < n; i++)
+      x += BigInt((long)i);
+    return x.to_int64();
+  });
+
+  bench("add small, new result", 10000000, [](unsigned long n) {
+    BigInt x(1), y(3);
+    int64_t sum = 0;
+    for(unsigned long i = 0; i < n; i++)
+    {
+      BigInt z = x + y;
+      sum += z.to_int64();
+    }
+    return sum;
+  });
+
+  bench("sub small", 10000000, [](unsigned long n) {
+    BigInt x(0);
+    for(unsigned long i = 0; i < n; i++)
+      x -= (long)(i & 0xff);
+    return x.to_int64();
+  });
+
+  bench("mul small", 10000000, [](unsigned long n) {
+    int64_t sum = 0;
+    for(unsigned long i = 0; i < n; i++)
+    {
+      BigInt x((long)(i & 0xffff));
+      x *= 40503;
+      sum += x.to_int64();
+    }
+    return sum;
+  });
+
+  bench("div/mod small", 10000000, [](unsigned long n) {
+    int64_t sum = 0;
+    for(unsigned long i = 0; i < n; i++)
+    {
+      BigInt x((unsigned long)i * 2654435761UL);
+      sum += (x / 8).to_int64() + (x % 8).to_int64();
+    }
+    return sum;
+  });
+
+  bench("compare small", 10000000, [](unsigned long n) {
+    BigInt x(1000);
+    int64_t sum = 0;
+    for(unsigned long i = 0; i < n; i++)
+      sum += x < (long)(i & 0x7ff);
+    return sum;
+  });
+
+  bench("add big", 1000000, [](unsigned long n) {
+    BigInt x = big_value(), y = big_value();
+    for(unsigned long i = 0; i < n; i++)
+      x += y;
+    return (int64_t)x.floorPow2();
+  });
+
+  bench("mul big", 1000000, [](unsigned long n) {
+    BigInt y = big_value();
+    int64_t sum = 0;
+    for(unsigned long i = 0; i < n; i++)
+    {
+      BigInt x = y * y;
+      sum += x.floorPow2();
+    }
+    return sum;
+  });
+
+  bench("as_string small", 1000000, [](unsigned long n) {
+    BigInt x(-123456789);
+    int64_t sum = 0;
+    char buf[64];
+    for(unsigned long i = 0; i < n; i++)
+      sum += *x.as_string(buf, sizeof(buf));
+    return sum;
+  });
+
+  return 0;
+}